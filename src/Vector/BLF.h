@@ -5,7 +5,17 @@
 #pragma once
 
 /* file load/save operations */
+#include <Vector/BLF/BlackBoxRecorder.h>
+#include <Vector/BLF/BlfArchive.h>
+#include <Vector/BLF/CancellationToken.h>
+#include <Vector/BLF/ConcurrentFileWriter.h>
+#include <Vector/BLF/Coroutines.h>
 #include <Vector/BLF/File.h>
+#include <Vector/BLF/LogContainerCache.h>
+#include <Vector/BLF/MultiFileReader.h>
+#include <Vector/BLF/ObjectStatistics.h>
+#include <Vector/BLF/ParallelFileReader.h>
+#include <Vector/BLF/RotatingFileWriter.h>
 
 /* exceptions */
 #include <Vector/BLF/Exceptions.h>
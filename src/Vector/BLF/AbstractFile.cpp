@@ -9,6 +9,11 @@
 namespace Vector {
 namespace BLF {
 
+void AbstractFile::writeGather(const WriteBuffer * buffers, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+        write(buffers[i].s, buffers[i].n);
+}
+
 void AbstractFile::skipp(std::streamsize s) {
     std::vector<char> zero;
     zero.resize(s);
@@ -6,6 +6,7 @@
 
 #include "platform.h"
 
+#include <cstddef>
 #include <ios>
 
 #include "vector_blf_export.h"
@@ -64,6 +65,25 @@ struct VECTOR_BLF_EXPORT AbstractFile {
      */
     virtual void write(const char * s, std::streamsize n) = 0;
 
+    /** data block for writeGather */
+    struct WriteBuffer {
+        /** pointer to data */
+        const char * s;
+
+        /** size of data */
+        std::streamsize n;
+    };
+
+    /**
+     * Write several blocks of data at once.
+     *
+     * The default implementation writes them one after the other.
+     *
+     * @param[in] buffers data blocks
+     * @param[in] count number of data blocks
+     */
+    virtual void writeGather(const WriteBuffer * buffers, std::size_t count);
+
     /**
      * Get position in output sequence.
      *
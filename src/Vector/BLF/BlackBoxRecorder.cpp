@@ -0,0 +1,306 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "BlackBoxRecorder.h"
+
+#include <cstdio>
+#include <limits>
+
+#include "Exceptions.h"
+#include "ObjectDispatch.h"
+
+namespace Vector {
+namespace BLF {
+
+/** Segment::objectOffset, if no object starts in the LogContainer */
+static const uint32_t noObject = std::numeric_limits<uint32_t>::max();
+
+BlackBoxRecorder::BlackBoxRecorder() {
+    /* all sealed LogContainers are taken over right away, so writes never wait */
+    m_uncompressedFile.setBufferSize(std::numeric_limits<std::streamsize>::max());
+}
+
+BlackBoxRecorder::~BlackBoxRecorder() {
+    try {
+        close();
+    } catch (const std::exception &) {
+        /* ignore file errors in destructor */
+    }
+}
+
+void BlackBoxRecorder::open(const std::string & baseName) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* check */
+    if (m_open)
+        return;
+
+    /* measurement starts now, if not given */
+    if (fileStatistics.measurementStartTime.year == 0)
+        fileStatistics.measurementStartTime = currentSystemTime();
+
+    m_baseName = baseName;
+    m_fileNames.clear();
+    m_uncompressedFile.setDefaultLogContainerSize(defaultLogContainerSize);
+    m_segment = Segment();
+    m_lastTimeStamp = 0;
+    m_open = true;
+}
+
+bool BlackBoxRecorder::is_open() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_open;
+}
+
+void BlackBoxRecorder::write(ObjectHeaderBase * ohb) {
+    std::unique_ptr<ObjectHeaderBase> object(ohb);
+
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* check */
+    if (!m_open)
+        throw Exception("BlackBoxRecorder::write(): Recorder is not open.");
+
+    /* end of post-trigger duration */
+    uint64_t timeStamp = objectTimeStampNs(*object);
+    if (m_file && (timeStamp > m_postTriggerEnd))
+        closeFile();
+    if (timeStamp > m_lastTimeStamp)
+        m_lastTimeStamp = timeStamp;
+
+    /* start a new log container, if the object doesn't fit in */
+    uint32_t objectSize = object->calculateObjectSize();
+    if (objectSize + objectSize % 4 > m_logContainerWriter.available())
+        seal();
+
+    /* statistics */
+    if (m_logContainerWriter.empty())
+        m_segment = Segment();
+    else if (m_segment.objectOffset == noObject)
+        m_segment.objectOffset = m_uncompressedFile.defaultLogContainerSize() - m_logContainerWriter.available();
+    if (object->objectType != ObjectType::Unknown115)
+        m_segment.objectCount++;
+    if (timeStamp > m_segment.lastTimeStamp)
+        m_segment.lastTimeStamp = timeStamp;
+
+    /* serialize into log container */
+    object->write(m_logContainerWriter);
+    takeLogContainers();
+
+    /* trigger */
+    if (triggerObjectTypes.count(object->objectType) > 0)
+        triggerAt(timeStamp);
+}
+
+void BlackBoxRecorder::trigger() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* check */
+    if (!m_open)
+        throw Exception("BlackBoxRecorder::trigger(): Recorder is not open.");
+
+    triggerAt(m_lastTimeStamp);
+}
+
+void BlackBoxRecorder::close() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* check */
+    if (!m_open)
+        return;
+    m_open = false;
+
+    /* complete file */
+    if (m_file)
+        closeFile();
+
+    /* drop history */
+    seal();
+    m_segments.clear();
+    m_memoryUsage = 0;
+}
+
+std::vector<std::string> BlackBoxRecorder::fileNames() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_fileNames;
+}
+
+std::size_t BlackBoxRecorder::memoryUsage() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_memoryUsage;
+}
+
+void BlackBoxRecorder::triggerAt(uint64_t timeStamp) {
+    /* a trigger within the post-trigger duration extends it */
+    uint64_t postTriggerEnd = timeStamp + static_cast<uint64_t>(postTriggerDuration.count());
+    if (m_file) {
+        if (postTriggerEnd > m_postTriggerEnd)
+            m_postTriggerEnd = postTriggerEnd;
+        return;
+    }
+    m_postTriggerEnd = postTriggerEnd;
+
+    /* write history */
+    seal();
+    openFile();
+}
+
+void BlackBoxRecorder::seal() {
+    m_logContainerWriter.seal();
+    takeLogContainers();
+}
+
+void BlackBoxRecorder::takeLogContainers() {
+    bool first = true;
+    while (m_uncompressedFile.tellg() < m_uncompressedFile.tellp()) {
+        /* get LogContainer */
+        Segment segment;
+        if (first) {
+            segment = m_segment;
+        } else {
+            /* continuation of a large object */
+            segment = Segment();
+            segment.lastTimeStamp = m_segment.lastTimeStamp;
+            segment.objectOffset = noObject;
+        }
+        segment.logContainer = m_uncompressedFile.readLogContainer();
+        m_uncompressedFile.dropOldData();
+        first = false;
+        compress(*segment.logContainer);
+
+        /* write into file or keep in history */
+        if (m_file) {
+            writeSegment(segment);
+        } else {
+            m_memoryUsage += segment.logContainer->compressedFile.size();
+            m_segments.push_back(segment);
+        }
+    }
+
+    /* a LogContainer, that was continued, doesn't start with an object */
+    if (!first && !m_logContainerWriter.empty()) {
+        uint64_t lastTimeStamp = m_segment.lastTimeStamp;
+        m_segment = Segment();
+        m_segment.lastTimeStamp = lastTimeStamp;
+        m_segment.objectOffset = noObject;
+    }
+
+    dropOldSegments();
+}
+
+void BlackBoxRecorder::compress(LogContainer & logContainer) const {
+    if (compressionLevel == 0) {
+        /* no compression */
+        logContainer.compress(0, 0);
+    } else {
+        /* zlib compression */
+        logContainer.compress(2, compressionLevel);
+    }
+    std::vector<uint8_t>().swap(logContainer.uncompressedFile);
+}
+
+void BlackBoxRecorder::dropOldSegments() {
+    const uint64_t duration = static_cast<uint64_t>(preTriggerDuration.count());
+    while (!m_segments.empty()) {
+        /* check limits */
+        const Segment & segment = m_segments.front();
+        bool tooOld =
+            (m_lastTimeStamp > segment.lastTimeStamp) &&
+            (m_lastTimeStamp - segment.lastTimeStamp > duration);
+        bool tooLarge =
+            (maxMemory > 0) &&
+            (m_memoryUsage > maxMemory);
+        if (!tooOld && !tooLarge)
+            break;
+
+        /* drop LogContainer */
+        m_memoryUsage -= segment.logContainer->compressedFile.size();
+        m_segments.pop_front();
+
+        /* drop the rest of its last object */
+        while (!m_segments.empty() && (m_segments.front().objectOffset == noObject)) {
+            m_memoryUsage -= m_segments.front().logContainer->compressedFile.size();
+            m_segments.pop_front();
+        }
+        if (!m_segments.empty() && (m_segments.front().objectOffset > 0)) {
+            Segment & front = m_segments.front();
+            LogContainer & logContainer = *front.logContainer;
+            m_memoryUsage -= logContainer.compressedFile.size();
+            logContainer.uncompress();
+            logContainer.uncompressedFile.erase(
+                logContainer.uncompressedFile.begin(),
+                logContainer.uncompressedFile.begin() + front.objectOffset);
+            logContainer.uncompressedFileSize = static_cast<uint32_t>(logContainer.uncompressedFile.size());
+            compress(logContainer);
+            m_memoryUsage += logContainer.compressedFile.size();
+            front.objectOffset = 0;
+        }
+    }
+}
+
+void BlackBoxRecorder::openFile() {
+    /* file name */
+    char index[16];
+    std::snprintf(index, sizeof(index), "_%04u.blf", static_cast<unsigned int>(m_fileNames.size()));
+    std::string fileName = m_baseName + index;
+
+    /* open file */
+    std::unique_ptr<CompressedFile> file(new CompressedFile);
+    file->open(fileName.c_str(), std::ios_base::out | std::ios_base::binary);
+    if (!file->is_open())
+        throw Exception("BlackBoxRecorder::openFile(): Unable to open file.");
+    m_file = std::move(file);
+    m_fileNames.push_back(fileName);
+
+    /* write file statistics */
+    m_fileStatistics = fileStatistics;
+    m_fileStatistics.uncompressedFileSize = m_fileStatistics.statisticsSize;
+    m_fileStatistics.objectCount = 0;
+    m_fileStatistics.write(*m_file);
+
+    /* write history, without compressing it again */
+    for (const Segment & segment : m_segments)
+        writeSegment(segment);
+    m_segments.clear();
+    m_memoryUsage = 0;
+}
+
+void BlackBoxRecorder::writeSegment(const Segment & segment) {
+    segment.logContainer->write(*m_file);
+
+    /* statistics */
+    m_fileStatistics.uncompressedFileSize +=
+        segment.logContainer->internalHeaderSize() +
+        segment.logContainer->uncompressedFileSize;
+    m_fileStatistics.objectCount += segment.objectCount;
+    if (segment.objectCount > 0)
+        m_fileStatistics.lastObjectTime = nsToSystemTime(
+            systemTimeToNs(m_fileStatistics.measurementStartTime) +
+            static_cast<int64_t>(segment.lastTimeStamp));
+}
+
+void BlackBoxRecorder::closeFile() {
+    /* write the objects up to now */
+    seal();
+
+    /* write fileStatistics and close file */
+    m_fileStatistics.fileSize = static_cast<uint64_t>(m_file->tellp());
+    m_file->seekp(0);
+    m_fileStatistics.write(*m_file);
+    m_file->close();
+    m_file.reset();
+}
+
+}
+}
@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CompressedFile.h"
+#include "FileStatistics.h"
+#include "LogContainer.h"
+#include "LogContainerWriter.h"
+#include "ObjectHeaderBase.h"
+#include "UncompressedFile.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Keeps the recent objects in memory, and writes them into a file only
+ * when a trigger occurs, like a flight recorder.
+ *
+ * The objects are serialized into LogContainers, which are compressed when
+ * they are full, so the history takes only the compressed size in memory.
+ * LogContainers, whose objects are older than preTriggerDuration, or that
+ * exceed maxMemory, are dropped.
+ *
+ * A trigger is an object of triggerObjectTypes, or a call of trigger().
+ * Then the history is written into a new file, without compressing it
+ * again, followed by the objects up to postTriggerDuration after the
+ * trigger. A trigger within this time extends it.
+ *
+ * The files are named <baseName>_<index>.blf, with a four digit index
+ * starting at 0. All files carry the same fileStatistics (application and
+ * measurementStartTime), so the object timestamps stay valid across files.
+ *
+ * Compression and writing is done in write(). The methods can be called
+ * from several threads, e.g. trigger() from another thread than write().
+ */
+class VECTOR_BLF_EXPORT BlackBoxRecorder final {
+  public:
+    BlackBoxRecorder();
+    virtual ~BlackBoxRecorder();
+
+    /**
+     * File statistics used as template for each file.
+     *
+     * Set application and measurementStartTime before open.
+     */
+    FileStatistics fileStatistics {};
+
+    /**
+     * Duration of the history, that is kept before a trigger.
+     *
+     * This is the difference between the object timestamps of the latest
+     * object and the latest object in a LogContainer. As whole LogContainers
+     * are dropped, the history can be longer by up to one LogContainer.
+     */
+    std::chrono::nanoseconds preTriggerDuration {std::chrono::minutes(5)};
+
+    /**
+     * Duration after a trigger, in which objects are written into the file.
+     *
+     * This is compared to the object timestamps.
+     */
+    std::chrono::nanoseconds postTriggerDuration {std::chrono::seconds(10)};
+
+    /**
+     * Maximum size in bytes of the compressed history.
+     *
+     * The LogContainer, that is currently filled, is not included.
+     *
+     * Zero disables the size limit.
+     */
+    std::size_t maxMemory {0};
+
+    /**
+     * Object types, that trigger a file.
+     */
+    std::set<ObjectType> triggerObjectTypes {
+        ObjectType::CAN_ERROR,
+        ObjectType::CAN_ERROR_EXT,
+        ObjectType::CAN_FD_ERROR_64,
+        ObjectType::TRIGGER_CONDITION
+    };
+
+    /** @copydoc File::compressionLevel */
+    int compressionLevel {1};
+
+    /** @copydoc File::defaultLogContainerSize */
+    uint32_t defaultLogContainerSize {0x20000};
+
+    /**
+     * Start recording.
+     *
+     * @param[in] baseName file name without index and extension
+     */
+    virtual void open(const std::string & baseName);
+
+    /**
+     * is recording?
+     *
+     * @return true if open
+     */
+    virtual bool is_open() const;
+
+    /**
+     * Write object.
+     *
+     * @param[in] ohb write object (ownership is taken)
+     */
+    virtual void write(ObjectHeaderBase * ohb);
+
+    /**
+     * Trigger a file at the latest object written.
+     */
+    virtual void trigger();
+
+    /**
+     * Stop recording.
+     *
+     * A file, that is currently written, is completed. The history is
+     * dropped.
+     */
+    virtual void close();
+
+    /**
+     * Get names of all files written so far.
+     *
+     * @return file names
+     */
+    virtual std::vector<std::string> fileNames() const;
+
+    /**
+     * Get size in bytes of the compressed history.
+     *
+     * @return compressed size of the LogContainers kept
+     */
+    virtual std::size_t memoryUsage() const;
+
+  private:
+    /** LogContainer in the history */
+    struct Segment {
+        /** compressed LogContainer */
+        std::shared_ptr<LogContainer> logContainer;
+
+        /** latest object timestamp in nanoseconds */
+        uint64_t lastTimeStamp;
+
+        /** number of objects starting in this LogContainer */
+        uint32_t objectCount;
+
+        /**
+         * position of the first object starting in this LogContainer
+         *
+         * This is not 0, if the LogContainer starts with the rest of an
+         * object, and noObject, if no object starts in it.
+         */
+        uint32_t objectOffset;
+    };
+
+    /** mutex */
+    mutable std::mutex m_mutex {};
+
+    /** recording */
+    bool m_open {false};
+
+    /** file name without index and extension */
+    std::string m_baseName {};
+
+    /** names of all files */
+    std::vector<std::string> m_fileNames {};
+
+    /** sealed LogContainers */
+    UncompressedFile m_uncompressedFile {};
+
+    /** write cursor into uncompressedFile */
+    LogContainerWriter m_logContainerWriter {m_uncompressedFile};
+
+    /** statistics of the LogContainer in m_logContainerWriter */
+    Segment m_segment {};
+
+    /** history */
+    std::deque<Segment> m_segments {};
+
+    /** compressed size of history */
+    std::size_t m_memoryUsage {};
+
+    /** latest object timestamp in nanoseconds */
+    uint64_t m_lastTimeStamp {};
+
+    /** file, that is currently written after a trigger */
+    std::unique_ptr<CompressedFile> m_file {};
+
+    /** file statistics of m_file */
+    FileStatistics m_fileStatistics {};
+
+    /** end of the post-trigger duration in nanoseconds */
+    uint64_t m_postTriggerEnd {};
+
+    /**
+     * Trigger a file.
+     *
+     * @param[in] timeStamp trigger timestamp in nanoseconds
+     */
+    void triggerAt(uint64_t timeStamp);
+
+    /**
+     * Seal the current LogContainer, and take over all sealed ones.
+     */
+    void seal();
+
+    /**
+     * Compress the sealed LogContainers, and add them to the history or
+     * the file.
+     */
+    void takeLogContainers();
+
+    /**
+     * Compress LogContainer, and release the uncompressed data.
+     *
+     * @param[in] logContainer LogContainer
+     */
+    void compress(LogContainer & logContainer) const;
+
+    /**
+     * Drop LogContainers from the history, that exceed the limits.
+     *
+     * The rest of an object at the begin of the history is cut off.
+     */
+    void dropOldSegments();
+
+    /** open next file and write the history into it */
+    void openFile();
+
+    /**
+     * Write LogContainer into the file.
+     *
+     * @param[in] segment LogContainer
+     */
+    void writeSegment(const Segment & segment);
+
+    /** complete the file and close it */
+    void closeFile();
+};
+
+}
+}
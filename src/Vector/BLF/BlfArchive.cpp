@@ -0,0 +1,313 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "BlfArchive.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "CompressedFile.h"
+#include "Exceptions.h"
+#include "File.h"
+#include "ObjectDispatch.h"
+#include "RestorePoints.h"
+
+namespace Vector {
+namespace BLF {
+
+BlfArchive::~BlfArchive() {
+    close();
+}
+
+void BlfArchive::open(const std::string & filename) {
+    /* check */
+    if (is_open())
+        return;
+
+    /* read file statistics */
+    CompressedFile compressedFile;
+    compressedFile.open(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!compressedFile.is_open())
+        throw Exception("BlfArchive::open(): Unable to open file.");
+    fileStatistics.read(compressedFile);
+    compressedFile.close();
+
+#ifdef _WIN32
+    /* read file */
+    std::ifstream ifs(filename, std::ios_base::in | std::ios_base::binary);
+    m_buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    if (m_buffer.empty())
+        throw Exception("BlfArchive::open(): Unable to read file.");
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    /* map file */
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw Exception("BlfArchive::open(): Unable to open file.");
+    struct stat st;
+    if ((::fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        ::close(fd);
+        throw Exception("BlfArchive::open(): Unable to map file.");
+    }
+    void * data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        throw Exception("BlfArchive::open(): Unable to map file.");
+    m_data = static_cast<const uint8_t *>(data);
+    m_size = static_cast<std::size_t>(st.st_size);
+#endif
+
+    /* cache */
+    if (!logContainerCache)
+        logContainerCache = LogContainerCache::forPath(filename);
+    m_fileIdentity = LogContainerCache::fileIdentity(filename);
+
+    /* index */
+    try {
+        readIndex();
+        readRestorePoints();
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+bool BlfArchive::is_open() const {
+    return m_data != nullptr;
+}
+
+void BlfArchive::close() {
+    /* check */
+    if (!is_open())
+        return;
+
+#ifdef _WIN32
+    std::vector<uint8_t>().swap(m_buffer);
+#else
+    ::munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_index.clear();
+    m_restorePoints.clear();
+}
+
+std::size_t BlfArchive::logContainerCount() const {
+    return m_index.size();
+}
+
+const std::vector<RestorePoint> & BlfArchive::restorePoints() const {
+    return m_restorePoints;
+}
+
+void BlfArchive::readIndex() {
+    /* hop over the LogContainer headers */
+    LogContainer logContainer;
+    const std::size_t internalHeaderSize = logContainer.internalHeaderSize();
+    std::size_t position = fileStatistics.statisticsSize;
+    while (position + internalHeaderSize <= m_size) {
+        std::memcpy(&logContainer.signature, m_data + position, sizeof(logContainer.signature));
+        std::memcpy(&logContainer.objectSize, m_data + position + 8, sizeof(logContainer.objectSize));
+        std::memcpy(&logContainer.objectType, m_data + position + 12, sizeof(logContainer.objectType));
+        if ((logContainer.signature != ObjectSignature) ||
+                (logContainer.objectType != ObjectType::LOG_CONTAINER) ||
+                (logContainer.objectSize < internalHeaderSize))
+            throw Exception("BlfArchive::readIndex(): Log container expected.");
+
+        /* an incomplete LogContainer at the end is not indexed */
+        if (position + logContainer.objectSize > m_size)
+            break;
+
+        Entry entry;
+        entry.position = position;
+        entry.objectSize = logContainer.objectSize;
+        m_index.push_back(entry);
+        position += logContainer.objectSize + logContainer.objectSize % 4;
+    }
+}
+
+void BlfArchive::readRestorePoints() {
+    /* restore points are at the end of the file */
+    std::size_t logContainer;
+    if ((fileStatistics.restorePointsOffset == 0) ||
+            !findLogContainer(fileStatistics.restorePointsOffset, logContainer))
+        return;
+
+    /* collect restore point data */
+    Cursor cursor(*this);
+    cursor.objectTypes.insert(ObjectType::Unknown115);
+    cursor.restart(logContainer, 0);
+    UncompressedFile restorePointsData;
+    while (ObjectHeaderBase * ohb = cursor.read()) {
+        std::unique_ptr<RestorePointContainer> restorePointContainer(static_cast<RestorePointContainer *>(ohb));
+        restorePointsData.write(reinterpret_cast<char *>(restorePointContainer->data.data()), restorePointContainer->dataLength);
+    }
+    restorePointsData.setFileSize(restorePointsData.tellp());
+    RestorePoints restorePoints;
+    restorePoints.read(restorePointsData);
+
+    /* only keep restore points, that refer to indexed LogContainers */
+    for (const RestorePoint & restorePoint : restorePoints.restorePoints) {
+        if (findLogContainer(restorePoint.compressedFilePosition, logContainer))
+            m_restorePoints.push_back(restorePoint);
+    }
+}
+
+bool BlfArchive::findLogContainer(uint64_t position, std::size_t & logContainer) const {
+    auto it = std::lower_bound(m_index.cbegin(), m_index.cend(), position, [](const Entry & entry, uint64_t position) {
+        return entry.position < position;
+    });
+    if ((it == m_index.cend()) || (it->position != position))
+        return false;
+    logContainer = static_cast<std::size_t>(it - m_index.cbegin());
+    return true;
+}
+
+std::shared_ptr<LogContainer> BlfArchive::uncompressedLogContainer(std::size_t logContainer) const {
+    const Entry & entry = m_index[logContainer];
+
+    /* take from cache, as UncompressedFile modifies its LogContainers */
+    std::shared_ptr<const LogContainer> cachedLogContainer = logContainerCache->get(m_fileIdentity, entry.position, entry.objectSize);
+    if (cachedLogContainer)
+        return std::make_shared<LogContainer>(*cachedLogContainer);
+
+    /* read headers */
+    std::shared_ptr<LogContainer> result = std::make_shared<LogContainer>();
+    const uint8_t * data = m_data + entry.position;
+    std::memcpy(&result->objectSize, data + 8, sizeof(result->objectSize));
+    std::memcpy(&result->compressionMethod, data + 16, sizeof(result->compressionMethod));
+    std::memcpy(&result->uncompressedFileSize, data + 24, sizeof(result->uncompressedFileSize));
+    result->compressedFileSize = result->objectSize - result->internalHeaderSize();
+
+    /* uncompress */
+    data += result->internalHeaderSize();
+    result->compressedFile.assign(data, data + result->compressedFileSize);
+    result->uncompress();
+    std::vector<uint8_t>().swap(result->compressedFile);
+    logContainerCache->put(m_fileIdentity, entry.position, *result);
+    return result;
+}
+
+BlfArchive::Cursor::Cursor(const BlfArchive & archive) :
+    m_archive(archive) {
+    if (!archive.is_open())
+        throw Exception("BlfArchive::Cursor::Cursor(): Archive is not open.");
+    restart(0, 0);
+}
+
+void BlfArchive::Cursor::seek(uint64_t timeStamp) {
+    /* latest restore point before the timestamp */
+    std::size_t logContainer = 0;
+    uint32_t offset = 0;
+    for (const RestorePoint & restorePoint : m_archive.m_restorePoints) {
+        if (restorePoint.timeStamp > timeStamp)
+            break;
+        m_archive.findLogContainer(restorePoint.compressedFilePosition, logContainer);
+        offset = restorePoint.uncompressedFileOffset;
+    }
+    restart(logContainer, offset);
+
+    /* skip objects before the timestamp */
+    for (;;) {
+        m_uncompressedFile->clear();
+        std::streampos position = m_uncompressedFile->tellg();
+        std::unique_ptr<ObjectHeaderBase> ohb(readObject());
+        if (!ohb)
+            break;
+        if (objectTimeStampNs(*ohb) >= timeStamp) {
+            m_uncompressedFile->clear();
+            m_uncompressedFile->seekg(position, std::ios_base::beg);
+            break;
+        }
+    }
+}
+
+ObjectHeaderBase * BlfArchive::Cursor::read() {
+    while (!m_eof) {
+        std::unique_ptr<ObjectHeaderBase> ohb(readObject());
+        if (!ohb)
+            break;
+
+        /* time filter */
+        uint64_t timeStamp = objectTimeStampNs(*ohb);
+        if (timeStamp > endTimeStamp) {
+            m_eof = true;
+            break;
+        }
+        if (timeStamp >= beginTimeStamp)
+            return ohb.release();
+    }
+    return nullptr;
+}
+
+bool BlfArchive::Cursor::eof() const {
+    return m_eof;
+}
+
+void BlfArchive::Cursor::restart(std::size_t logContainer, uint32_t offset) {
+    m_uncompressedFile.reset(new UncompressedFile);
+    m_nextLogContainer = logContainer;
+    m_eof = false;
+    fill(offset);
+    m_uncompressedFile->seekg(offset, std::ios_base::beg);
+}
+
+bool BlfArchive::Cursor::fill(std::streamsize size) {
+    m_uncompressedFile->clear();
+    while (m_uncompressedFile->tellp() - m_uncompressedFile->tellg() < size) {
+        /* end of file */
+        if (m_nextLogContainer >= m_archive.m_index.size()) {
+            m_uncompressedFile->setFileSize(m_uncompressedFile->tellp());
+            return false;
+        }
+        m_uncompressedFile->write(m_archive.uncompressedLogContainer(m_nextLogContainer));
+        m_nextLogContainer++;
+    }
+    return true;
+}
+
+ObjectHeaderBase * BlfArchive::Cursor::readObject() {
+    for (;;) {
+        m_uncompressedFile->dropOldData();
+
+        /* read header to identify type */
+        ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+        if (!fill(ohb.calculateHeaderSize())) {
+            m_eof = true;
+            return nullptr;
+        }
+        ohb.read(*m_uncompressedFile);
+        m_uncompressedFile->seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
+        if (!fill(ohb.objectSize))
+            throw Exception("BlfArchive::Cursor::read(): Read beyond end of file.");
+
+        /* skip objects of unknown type or not of objectTypes */
+        if (!isSupportedObjectType(ohb.objectType) ||
+                (!objectTypes.empty() && (objectTypes.count(ohb.objectType) == 0))) {
+            m_uncompressedFile->seekg(ohb.objectSize + ohb.objectSize % 4, std::ios_base::cur);
+            continue;
+        }
+
+        /* read object */
+        std::unique_ptr<ObjectHeaderBase> obj(File::createObject(ohb.objectType));
+        obj->read(*m_uncompressedFile);
+        if (!m_uncompressedFile->good())
+            throw Exception("BlfArchive::Cursor::read(): Read beyond end of file.");
+        return obj.release();
+    }
+}
+
+}
+}
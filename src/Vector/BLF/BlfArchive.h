@@ -0,0 +1,252 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "FileStatistics.h"
+#include "LogContainer.h"
+#include "LogContainerCache.h"
+#include "ObjectHeaderBase.h"
+#include "RestorePoint.h"
+#include "UncompressedFile.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * File opened once for reading, by any number of cursors.
+ *
+ * The file is mapped into memory. At open, an index of the LogContainers is
+ * built from their headers, without uncompressing them, and the restore
+ * points are read. The uncompressed LogContainers are shared in a
+ * LogContainerCache.
+ *
+ * The archive doesn't change after open, so cursors can be used from
+ * different threads, each cursor by one thread at a time.
+ */
+class VECTOR_BLF_EXPORT BlfArchive final {
+  public:
+    BlfArchive() = default;
+    virtual ~BlfArchive();
+
+    BlfArchive(const BlfArchive &) = delete;
+    BlfArchive & operator=(const BlfArchive &) = delete;
+    BlfArchive(BlfArchive &&) = delete;
+    BlfArchive & operator=(BlfArchive &&) = delete;
+
+    /**
+     * Read cursor with its own position and filters.
+     *
+     * The archive needs to stay open, while the cursor is used.
+     */
+    class VECTOR_BLF_EXPORT Cursor final {
+      public:
+        /**
+         * Constructor
+         *
+         * The cursor starts at the first object.
+         *
+         * @param[in] archive open archive
+         */
+        explicit Cursor(const BlfArchive & archive);
+        virtual ~Cursor() = default;
+
+        /**
+         * Object types, that are read.
+         *
+         * Other objects are skipped without decoding them. An empty set
+         * reads all object types.
+         */
+        std::set<ObjectType> objectTypes {};
+
+        /**
+         * Objects before this timestamp in nanoseconds are skipped.
+         */
+        uint64_t beginTimeStamp {0};
+
+        /**
+         * Reading ends at the first object after this timestamp in
+         * nanoseconds, as objects are ordered by time.
+         */
+        uint64_t endTimeStamp {std::numeric_limits<uint64_t>::max()};
+
+        /**
+         * Go to the first object at or after a timestamp.
+         *
+         * The cursor starts at the latest restore point before the
+         * timestamp, or at the first object without restore points.
+         *
+         * @param[in] timeStamp timestamp in nanoseconds
+         */
+        virtual void seek(uint64_t timeStamp);
+
+        /**
+         * Read the next object.
+         *
+         * @return read object or nullptr at the end (ownership is passed)
+         */
+        virtual ObjectHeaderBase * read();
+
+        /**
+         * is eof reached?
+         *
+         * @return true if the end was reached
+         */
+        virtual bool eof() const;
+
+      private:
+        friend class BlfArchive;
+
+        /** archive */
+        const BlfArchive & m_archive;
+
+        /** index of the next LogContainer to uncompress */
+        std::size_t m_nextLogContainer {};
+
+        /** uncompressed LogContainers from the current position on */
+        std::unique_ptr<UncompressedFile> m_uncompressedFile {};
+
+        /** eof */
+        bool m_eof {};
+
+        /**
+         * Start reading at an object.
+         *
+         * @param[in] logContainer index of the LogContainer
+         * @param[in] offset offset of the object in the uncompressed LogContainer
+         */
+        void restart(std::size_t logContainer, uint32_t offset);
+
+        /**
+         * Uncompress further LogContainers, until there is enough data.
+         *
+         * @param[in] size needed data size in bytes
+         * @return false if there is not enough data till the end
+         */
+        bool fill(std::streamsize size);
+
+        /**
+         * Read the next object of objectTypes.
+         *
+         * @return read object or nullptr at the end
+         */
+        ObjectHeaderBase * readObject();
+    };
+
+    /**
+     * Cache of uncompressed LogContainers.
+     *
+     * If not set, LogContainerCache::forPath is used at open.
+     */
+    std::shared_ptr<LogContainerCache> logContainerCache {};
+
+    /**
+     * File statistics, read at open.
+     */
+    FileStatistics fileStatistics {};
+
+    /**
+     * Open file.
+     *
+     * @param[in] filename file name
+     */
+    virtual void open(const std::string & filename);
+
+    /**
+     * is file open?
+     *
+     * @return true if file is open
+     */
+    virtual bool is_open() const;
+
+    /**
+     * Close file.
+     */
+    virtual void close();
+
+    /**
+     * Get number of LogContainers.
+     *
+     * An incomplete LogContainer at the end of the file is not included.
+     *
+     * @return number of LogContainers
+     */
+    virtual std::size_t logContainerCount() const;
+
+    /**
+     * Get restore points.
+     *
+     * @return restore points, that refer to indexed LogContainers
+     */
+    virtual const std::vector<RestorePoint> & restorePoints() const;
+
+  private:
+    /** LogContainer in the index */
+    struct Entry {
+        /** position in the compressed file */
+        uint64_t position;
+
+        /** objectSize */
+        uint32_t objectSize;
+    };
+
+    /** file data */
+    const uint8_t * m_data {nullptr};
+
+    /** file size */
+    std::size_t m_size {};
+
+    /** identity of the file for logContainerCache */
+    LogContainerCache::FileIdentity m_fileIdentity {};
+
+#ifdef _WIN32
+    /** file data, as there is no mapping */
+    std::vector<uint8_t> m_buffer {};
+#endif
+
+    /** index of the LogContainers */
+    std::vector<Entry> m_index {};
+
+    /** restore points */
+    std::vector<RestorePoint> m_restorePoints {};
+
+    /** build m_index */
+    void readIndex();
+
+    /** read m_restorePoints */
+    void readRestorePoints();
+
+    /**
+     * Find LogContainer by its position.
+     *
+     * @param[in] position position in the compressed file
+     * @param[out] logContainer index of the LogContainer
+     * @return true if found
+     */
+    bool findLogContainer(uint64_t position, std::size_t & logContainer) const;
+
+    /**
+     * Get uncompressed LogContainer.
+     *
+     * It's taken from the cache, or uncompressed and put into the cache.
+     *
+     * @param[in] logContainer index of the LogContainer
+     * @return own copy of the uncompressed LogContainer
+     */
+    std::shared_ptr<LogContainer> uncompressedLogContainer(std::size_t logContainer) const;
+};
+
+}
+}
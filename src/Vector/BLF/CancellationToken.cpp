@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CancellationToken.h"
+
+namespace Vector {
+namespace BLF {
+
+void CancellationToken::cancel() {
+    /* mutex lock, functions are called with it, so unregister waits for them */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_cancelled.exchange(true))
+        return;
+    for (auto & function : m_functions)
+        function.second();
+}
+
+bool CancellationToken::cancelled() const {
+    return m_cancelled;
+}
+
+uint64_t CancellationToken::registerFunction(std::function<void()> function) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_cancelled)
+        function();
+    uint64_t id = m_nextId++;
+    m_functions[id] = std::move(function);
+    return id;
+}
+
+void CancellationToken::unregisterFunction(uint64_t id) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_functions.erase(id);
+}
+
+}
+}
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Token to cancel long running operations.
+ *
+ * Files, that have the token set, register themselves at open. When the
+ * token is cancelled, e.g. from a UI thread, their read pipelines are
+ * stopped without draining the remaining data. One token can be shared by
+ * several Files.
+ *
+ * The methods are thread-safe.
+ */
+class VECTOR_BLF_EXPORT CancellationToken final {
+  public:
+    CancellationToken() = default;
+    virtual ~CancellationToken() = default;
+
+    CancellationToken(const CancellationToken &) = delete;
+    CancellationToken & operator=(const CancellationToken &) = delete;
+
+    /**
+     * Cancel.
+     *
+     * The registered functions are called once, in the calling thread.
+     */
+    virtual void cancel();
+
+    /**
+     * Was cancel called?
+     *
+     * @return true if cancelled
+     */
+    virtual bool cancelled() const;
+
+    /**
+     * Register a function, that is called on cancel.
+     *
+     * If the token is already cancelled, the function is called directly.
+     * The function must not register or unregister functions itself.
+     *
+     * @param[in] function function
+     * @return registration id
+     */
+    virtual uint64_t registerFunction(std::function<void()> function);
+
+    /**
+     * Unregister a function.
+     *
+     * After return, the function is not called anymore, and also not
+     * running in another thread.
+     *
+     * @param[in] id registration id
+     */
+    virtual void unregisterFunction(uint64_t id);
+
+  private:
+    /** cancelled */
+    std::atomic<bool> m_cancelled {false};
+
+    /** registered functions */
+    std::map<uint64_t, std::function<void()>> m_functions {};
+
+    /** next registration id */
+    uint64_t m_nextId {1};
+
+    /** mutex for m_functions and m_nextId */
+    mutable std::mutex m_mutex {};
+};
+
+}
+}
@@ -4,9 +4,350 @@
 
 #include "CompressedFile.h"
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+#ifdef VECTOR_BLF_USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 namespace Vector {
 namespace BLF {
 
+#ifndef _WIN32
+/** alignment of read-ahead buffer, file positions and sizes for O_DIRECT */
+static const std::size_t readAheadAlignment = 4096;
+#endif
+
+#ifdef VECTOR_BLF_USE_IO_URING
+/**
+ * Asynchronous read-ahead with io_uring.
+ *
+ * Consecutive windows of a file are read into several buffers in parallel.
+ * When a buffer is handed out, the buffers before it are submitted again
+ * for the windows after the last submitted one. A read at another position
+ * restarts the read-ahead there.
+ *
+ * This uses the kernel interface directly, so no liburing is needed.
+ */
+class IoUringReader final {
+  public:
+    ~IoUringReader() {
+        /* buffers must not be freed while the kernel writes into them */
+        while (m_pending > 0)
+            if (!waitForCompletion())
+                break;
+        for (Slot & slot : m_slots)
+            std::free(slot.buffer);
+        if (m_sqes != MAP_FAILED)
+            ::munmap(m_sqes, m_sqesSize);
+        if ((m_cqRing != MAP_FAILED) && (m_cqRing != m_sqRing))
+            ::munmap(m_cqRing, m_cqRingSize);
+        if (m_sqRing != MAP_FAILED)
+            ::munmap(m_sqRing, m_sqRingSize);
+        if (m_ringFd >= 0)
+            ::close(m_ringFd);
+    }
+
+    /**
+     * Setup io_uring and buffers.
+     *
+     * @param[in] fd file descriptor
+     * @param[in] bufferSize size of each buffer, aligned
+     * @param[in] depth number of buffers
+     * @return false if io_uring is not available
+     */
+    bool open(int fd, std::size_t bufferSize, unsigned int depth) {
+        m_fd = fd;
+        m_bufferSize = bufferSize;
+
+        /* setup ring */
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+        if (m_ringFd < 0)
+            return false;
+
+        /* map submission and completion queue */
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        m_sqRing = ::mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+        if (m_sqRing == MAP_FAILED)
+            return false;
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            m_cqRing = m_sqRing;
+        else
+            m_cqRing = ::mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED)
+            return false;
+        m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        m_sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+        if (m_sqes == MAP_FAILED)
+            return false;
+        char * sqRing = static_cast<char *>(m_sqRing);
+        m_sqTail = reinterpret_cast<unsigned int *>(sqRing + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned int *>(sqRing + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned int *>(sqRing + params.sq_off.array);
+        char * cqRing = static_cast<char *>(m_cqRing);
+        m_cqHead = reinterpret_cast<unsigned int *>(cqRing + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned int *>(cqRing + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned int *>(cqRing + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<struct io_uring_cqe *>(cqRing + params.cq_off.cqes);
+
+        /* allocate buffers, aligned for O_DIRECT */
+        m_slots.resize(std::min(depth, params.sq_entries));
+        for (Slot & slot : m_slots) {
+            void * buffer = nullptr;
+            if (::posix_memalign(&buffer, readAheadAlignment, m_bufferSize) != 0)
+                return false;
+            slot.buffer = static_cast<char *>(buffer);
+        }
+        return true;
+    }
+
+    /**
+     * Get the window at a position.
+     *
+     * The buffer is valid until the next call.
+     *
+     * @param[in] position aligned file position
+     * @param[out] buffer buffer
+     * @param[out] size number of bytes read
+     */
+    void read(std::streamoff position, char *& buffer, std::size_t & size) {
+        /* find window */
+        Slot * current = nullptr;
+        for (Slot & slot : m_slots)
+            if (slot.submitted && (slot.position == position))
+                current = &slot;
+
+        /* restart read-ahead at position */
+        if (current == nullptr) {
+            while (m_pending > 0)
+                if (!waitForCompletion())
+                    break;
+            for (Slot & slot : m_slots)
+                slot.submitted = false;
+            m_nextPosition = position;
+            m_endOfFile = -1;
+            current = &m_slots.front();
+            submit(*current);
+        }
+
+        /* reuse buffers before the window for the next windows */
+        for (Slot & slot : m_slots)
+            if ((&slot != current) && (!slot.submitted || (!slot.pending && (slot.position < position))))
+                submit(slot);
+
+        /* wait for window */
+        while (current->pending)
+            if (!waitForCompletion())
+                break;
+
+        /* read synchronously, e.g. if the kernel doesn't know IORING_OP_READ */
+        if (current->pending || (current->result < 0)) {
+            while (m_pending > 0)
+                if (!waitForCompletion())
+                    break;
+            ssize_t result;
+            do {
+                result = ::pread(m_fd, current->buffer, m_bufferSize, static_cast<off_t>(position));
+            } while ((result < 0) && (errno == EINTR));
+            current->result = static_cast<int>(result);
+            current->pending = false;
+        }
+        buffer = current->buffer;
+        size = (!current->pending && (current->result > 0)) ? static_cast<std::size_t>(current->result) : 0;
+    }
+
+    /**
+     * Discard all windows, e.g. because the file has grown.
+     *
+     * The next read restarts the read-ahead.
+     */
+    void reset() {
+        while (m_pending > 0)
+            if (!waitForCompletion())
+                break;
+        for (Slot & slot : m_slots)
+            slot.submitted = false;
+    }
+
+  private:
+    /** buffer with the read of a window */
+    struct Slot {
+        /** buffer */
+        char * buffer {nullptr};
+
+        /** file position of window */
+        std::streamoff position {};
+
+        /** bytes read, or negative error */
+        int result {};
+
+        /** read was submitted */
+        bool submitted {false};
+
+        /** read is not completed */
+        bool pending {false};
+    };
+
+    /**
+     * Submit a read of the next window.
+     *
+     * @param[in] slot buffer
+     */
+    void submit(Slot & slot) {
+        /* nothing to read after end of file */
+        slot.submitted = false;
+        if ((m_endOfFile >= 0) && (m_nextPosition >= m_endOfFile))
+            return;
+
+        /* prepare submission queue entry */
+        unsigned int tail = *m_sqTail;
+        unsigned int index = tail & m_sqMask;
+        struct io_uring_sqe * sqe = &static_cast<struct io_uring_sqe *>(m_sqes)[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = m_fd;
+        sqe->off = static_cast<uint64_t>(m_nextPosition);
+        sqe->addr = reinterpret_cast<uint64_t>(slot.buffer);
+        sqe->len = static_cast<uint32_t>(m_bufferSize);
+        sqe->user_data = static_cast<uint64_t>(&slot - m_slots.data());
+        m_sqArray[index] = index;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        /* submit */
+        int result;
+        do {
+            result = static_cast<int>(::syscall(__NR_io_uring_enter, m_ringFd, 1, 0, 0, nullptr, 0));
+        } while ((result < 0) && (errno == EINTR));
+        if (result < 1) {
+            /* read synchronously */
+            __atomic_store_n(m_sqTail, tail, __ATOMIC_RELEASE);
+            ssize_t size;
+            do {
+                size = ::pread(m_fd, slot.buffer, m_bufferSize, static_cast<off_t>(m_nextPosition));
+            } while ((size < 0) && (errno == EINTR));
+            slot.result = static_cast<int>(size);
+            slot.pending = false;
+        } else {
+            slot.pending = true;
+            m_pending++;
+        }
+        slot.position = m_nextPosition;
+        slot.submitted = true;
+        m_nextPosition += static_cast<std::streamoff>(m_bufferSize);
+    }
+
+    /**
+     * Wait for a completion.
+     *
+     * @return false on error
+     */
+    bool waitForCompletion() {
+        for (;;) {
+            unsigned int head = *m_cqHead;
+            if (head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)) {
+                struct io_uring_cqe * cqe = &m_cqes[head & m_cqMask];
+                Slot & slot = m_slots[static_cast<std::size_t>(cqe->user_data)];
+                slot.result = cqe->res;
+                slot.pending = false;
+                m_pending--;
+                __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+
+                /* remember end of file */
+                if ((slot.result >= 0) && (static_cast<std::size_t>(slot.result) < m_bufferSize)) {
+                    std::streamoff endOfFile = slot.position + slot.result;
+                    if ((m_endOfFile < 0) || (endOfFile < m_endOfFile))
+                        m_endOfFile = endOfFile;
+                }
+                return true;
+            }
+            if ((::syscall(__NR_io_uring_enter, m_ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) && (errno != EINTR))
+                return false;
+        }
+    }
+
+    /** file descriptor */
+    int m_fd {-1};
+
+    /** size of each buffer */
+    std::size_t m_bufferSize {};
+
+    /** buffers */
+    std::vector<Slot> m_slots {};
+
+    /** number of submitted, but not completed reads */
+    unsigned int m_pending {};
+
+    /** file position of the next window to submit */
+    std::streamoff m_nextPosition {};
+
+    /** end of file, or -1 if not yet known */
+    std::streamoff m_endOfFile {-1};
+
+    /** io_uring file descriptor */
+    int m_ringFd {-1};
+
+    /** submission queue ring */
+    void * m_sqRing {MAP_FAILED};
+
+    /** size of submission queue ring */
+    std::size_t m_sqRingSize {};
+
+    /** completion queue ring */
+    void * m_cqRing {MAP_FAILED};
+
+    /** size of completion queue ring */
+    std::size_t m_cqRingSize {};
+
+    /** submission queue entries */
+    void * m_sqes {MAP_FAILED};
+
+    /** size of submission queue entries */
+    std::size_t m_sqesSize {};
+
+    /** submission queue tail */
+    unsigned int * m_sqTail {nullptr};
+
+    /** submission queue mask */
+    unsigned int m_sqMask {};
+
+    /** submission queue array */
+    unsigned int * m_sqArray {nullptr};
+
+    /** completion queue head */
+    unsigned int * m_cqHead {nullptr};
+
+    /** completion queue tail */
+    unsigned int * m_cqTail {nullptr};
+
+    /** completion queue mask */
+    unsigned int m_cqMask {};
+
+    /** completion queue entries */
+    struct io_uring_cqe * m_cqes {nullptr};
+};
+#endif
+
 CompressedFile::~CompressedFile() {
     close();
 }
@@ -15,13 +356,66 @@ std::streamsize CompressedFile::gcount() const {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0)
+        return m_gcount;
+#endif
     return m_file.gcount();
 }
 
 void CompressedFile::read(char * s, std::streamsize n) {
+#ifdef VECTOR_BLF_USE_METRICS
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    readData(s, n);
+    m_readCounters.add(static_cast<uint64_t>(gcount()), std::chrono::steady_clock::now() - start);
+#else
+    readData(s, n);
+#endif
+}
+
+StageMetrics CompressedFile::readMetrics() const {
+    return m_readCounters.metrics();
+}
+
+void CompressedFile::readData(char * s, std::streamsize n) {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        m_gcount = 0;
+        if (m_fail || m_eof) {
+            m_fail = true;
+            return;
+        }
+        if ((m_buffer == nullptr) && (m_ioUringReader == nullptr)) {
+            /* opened for writing only */
+            m_fail = true;
+            return;
+        }
+        while (n > 0) {
+            /* refill read-ahead buffer */
+            if ((m_position < m_bufferPosition) ||
+                    (m_position >= m_bufferPosition + static_cast<std::streamoff>(m_bufferSize))) {
+                if (!fillBuffer()) {
+                    m_eof = true;
+                    m_fail = true;
+                    return;
+                }
+            }
+
+            /* copy from read-ahead buffer */
+            std::size_t offset = static_cast<std::size_t>(m_position - m_bufferPosition);
+            std::size_t size = std::min<std::size_t>(static_cast<std::size_t>(n), m_bufferSize - offset);
+            std::memcpy(s, m_buffer + offset, size);
+            s += size;
+            n -= static_cast<std::streamsize>(size);
+            m_position += static_cast<std::streamoff>(size);
+            m_gcount += static_cast<std::streamsize>(size);
+        }
+        return;
+    }
+#endif
     m_file.read(s, n);
 }
 
@@ -29,6 +423,10 @@ std::streampos CompressedFile::tellg() {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0)
+        return m_fail ? std::streampos(-1) : std::streampos(m_position);
+#endif
     return m_file.tellg();
 }
 
@@ -36,6 +434,30 @@ void CompressedFile::seekg(std::streamoff off, const std::ios_base::seekdir way)
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        m_eof = false;
+        if (m_fail)
+            return;
+        std::streamoff position = off;
+        if (way == std::ios_base::cur) {
+            position += m_position;
+        } else if (way == std::ios_base::end) {
+            struct stat fileStatus;
+            if (::fstat(m_fd, &fileStatus) != 0) {
+                m_fail = true;
+                return;
+            }
+            position += static_cast<std::streamoff>(fileStatus.st_size);
+        }
+        if (position < 0) {
+            m_fail = true;
+            return;
+        }
+        m_position = position;
+        return;
+    }
+#endif
     m_file.seekg(off, way);
 }
 
@@ -43,13 +465,38 @@ void CompressedFile::write(const char * s, std::streamsize n) {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        const WriteBuffer buffer { s, n };
+        writeDescriptor(&buffer, 1);
+        return;
+    }
+#endif
     m_file.write(s, n);
 }
 
+void CompressedFile::writeGather(const WriteBuffer * buffers, std::size_t count) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        writeDescriptor(buffers, count);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i)
+        m_file.write(buffers[i].s, buffers[i].n);
+}
+
 std::streampos CompressedFile::tellp() {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0)
+        return m_fail ? std::streampos(-1) : std::streampos(m_position);
+#endif
     return m_file.tellp();
 }
 
@@ -57,6 +504,10 @@ bool CompressedFile::good() const {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0)
+        return !m_fail && !m_eof;
+#endif
     return m_file.good();
 }
 
@@ -64,6 +515,10 @@ bool CompressedFile::eof() const {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0)
+        return m_eof;
+#endif
     return m_file.eof();
 }
 
@@ -71,6 +526,13 @@ void CompressedFile::open(const char * filename, std::ios_base::openmode openMod
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    m_filename = filename;
+#ifndef _WIN32
+    /* files opened for writing always use the descriptor, e.g. for sync */
+    openDescriptor(filename, openMode);
+    if ((m_fd >= 0) || (openMode & std::ios_base::out))
+        return;
+#endif
     m_file.open(filename, openMode);
 }
 
@@ -78,6 +540,10 @@ bool CompressedFile::is_open() const {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0)
+        return true;
+#endif
     return m_file.is_open();
 }
 
@@ -85,15 +551,302 @@ void CompressedFile::close() {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    if (m_fd >= 0) {
+#ifdef VECTOR_BLF_USE_IO_URING
+        if (m_ioUringReader) {
+            delete m_ioUringReader;
+            m_ioUringReader = nullptr;
+        } else
+#endif
+            std::free(m_buffer);
+        m_buffer = nullptr;
+        ::close(m_fd);
+        m_fd = -1;
+        m_bufferCapacity = 0;
+        m_bufferSize = 0;
+        return;
+    }
+#endif
     m_file.close();
 }
 
+void CompressedFile::flush() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+#ifndef _WIN32
+    /* writes are not buffered */
+    if (m_fd >= 0)
+        return;
+#endif
+
+    /* flush stream buffer */
+    m_file.flush();
+}
+
+void CompressedFile::sync() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+#ifndef _WIN32
+    /* writes are not buffered */
+    if (m_fd >= 0)
+        ::fsync(m_fd);
+#else
+    /* flush stream buffer */
+    m_file.flush();
+
+    /* sync file to disk */
+    int fd = ::_open(m_filename.c_str(), _O_RDWR | _O_BINARY);
+    if (fd >= 0) {
+        ::_commit(fd);
+        ::_close(fd);
+    }
+#endif
+}
+
+void CompressedFile::truncate(std::streampos size) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        /* read-ahead data might be cut off */
+        m_bufferSize = 0;
+        if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+            m_fail = true;
+        return;
+    }
+
+    /* std::fstream is only used for reading */
+    m_file.setstate(std::ios_base::failbit);
+#else
+    /* flush stream buffer */
+    m_file.flush();
+
+    /* std::fstream can't truncate, so the file is opened again */
+    int fd = ::_open(m_filename.c_str(), _O_RDWR | _O_BINARY);
+    if ((fd < 0) || (::_chsize_s(fd, static_cast<__int64>(size)) != 0))
+        m_file.setstate(std::ios_base::failbit);
+    if (fd >= 0)
+        ::_close(fd);
+#endif
+}
+
+void CompressedFile::clear() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        m_eof = false;
+        m_fail = false;
+        return;
+    }
+#endif
+    m_file.clear();
+}
+
+void CompressedFile::discardReadAhead() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+#ifndef _WIN32
+    if (m_fd >= 0) {
+#ifdef VECTOR_BLF_USE_IO_URING
+        if (m_ioUringReader)
+            m_ioUringReader->reset();
+#endif
+        m_bufferSize = 0;
+    }
+#endif
+    /* std::fstream discards its buffer on seekg */
+}
+
 void CompressedFile::seekp(std::streampos pos) {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+#ifndef _WIN32
+    /* get and put position are the same */
+    if (m_fd >= 0) {
+        if (!m_fail)
+            m_position = pos;
+        return;
+    }
+#endif
     m_file.seekp(pos);
 }
 
+#ifndef _WIN32
+void CompressedFile::openDescriptor(const char * filename, std::ios_base::openmode openMode) {
+    /* flags as std::fstream */
+    const bool in = openMode & std::ios_base::in;
+    const bool out = openMode & std::ios_base::out;
+    const bool app = openMode & std::ios_base::app;
+    int flags;
+    if (app)
+        flags = (in ? O_RDWR : O_WRONLY) | O_CREAT | O_APPEND;
+    else if (in && out)
+        flags = O_RDWR | ((openMode & std::ios_base::trunc) ? O_CREAT | O_TRUNC : 0);
+    else if (out)
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    else if (in)
+        flags = O_RDONLY;
+    else
+        return;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+
+    /* open file, without O_DIRECT if the file system doesn't support it */
+#ifdef O_DIRECT
+    if (directIo && !out)
+        m_fd = ::open(filename, flags | O_DIRECT, 0666);
+#endif
+    if (m_fd < 0)
+        m_fd = ::open(filename, flags, 0666);
+    if (m_fd < 0)
+        return;
+    m_bufferPosition = 0;
+    m_bufferSize = 0;
+    m_position = 0;
+    m_gcount = 0;
+    m_eof = false;
+    m_fail = false;
+    m_append = app;
+
+    /* start at the end */
+    if (openMode & std::ios_base::ate) {
+        off_t position = ::lseek(m_fd, 0, SEEK_END);
+        if (position > 0)
+            m_position = position;
+    }
+    if (!in)
+        return;
+
+    /* read-ahead buffer size */
+    m_bufferCapacity = std::max(readAheadSize, readAheadAlignment);
+    m_bufferCapacity = (m_bufferCapacity + readAheadAlignment - 1) / readAheadAlignment * readAheadAlignment;
+
+    /* asynchronous read-ahead buffers */
+#ifdef VECTOR_BLF_USE_IO_URING
+    if ((readAheadDepth > 1) && !out) {
+        m_ioUringReader = new IoUringReader;
+        if (!m_ioUringReader->open(m_fd, m_bufferCapacity, readAheadDepth)) {
+            delete m_ioUringReader;
+            m_ioUringReader = nullptr;
+        }
+    }
+    if (!m_ioUringReader)
+#endif
+    {
+        /* allocate read-ahead buffer */
+        void * buffer = nullptr;
+        if (::posix_memalign(&buffer, readAheadAlignment, m_bufferCapacity) != 0) {
+            ::close(m_fd);
+            m_fd = -1;
+            return;
+        }
+        m_buffer = static_cast<char *>(buffer);
+    }
+
+    /* files are mostly read sequentially */
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+void CompressedFile::writeDescriptor(const WriteBuffer * buffers, std::size_t count) {
+    /* check state */
+    if (m_fail || m_eof) {
+        m_fail = true;
+        return;
+    }
+
+    /* read-ahead buffer gets outdated */
+    m_bufferSize = 0;
+
+    /* gather data blocks */
+    std::vector<struct iovec> iov;
+    iov.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (buffers[i].n <= 0)
+            continue;
+        struct iovec v;
+        v.iov_base = const_cast<char *>(buffers[i].s);
+        v.iov_len = static_cast<std::size_t>(buffers[i].n);
+        iov.push_back(v);
+    }
+    if (iov.empty())
+        return;
+
+    /* write at current position, or at the end in append mode */
+    off_t position = m_append ?
+        ::lseek(m_fd, 0, SEEK_END) :
+        ::lseek(m_fd, static_cast<off_t>(m_position), SEEK_SET);
+    if (position < 0) {
+        m_fail = true;
+        return;
+    }
+    m_position = position;
+    std::size_t first = 0;
+    while (first < iov.size()) {
+        ssize_t written = ::writev(m_fd, &iov[first], static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX)));
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            m_fail = true;
+            return;
+        }
+        m_position += written;
+
+        /* skip completely written blocks, and advance in partially written one */
+        std::size_t remaining = static_cast<std::size_t>(written);
+        while ((first < iov.size()) && (remaining >= iov[first].iov_len)) {
+            remaining -= iov[first].iov_len;
+            first++;
+        }
+        if (remaining > 0) {
+            iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+}
+
+bool CompressedFile::fillBuffer() {
+    /* drop the data, that is already in the read-ahead buffer, from page cache */
+#ifdef POSIX_FADV_DONTNEED
+    if (dropPageCache && (m_bufferSize > 0))
+        ::posix_fadvise(m_fd, m_bufferPosition, static_cast<off_t>(m_bufferSize), POSIX_FADV_DONTNEED);
+#endif
+
+    /* read at aligned position */
+    std::streamoff position = m_position / static_cast<std::streamoff>(readAheadAlignment) * static_cast<std::streamoff>(readAheadAlignment);
+#ifdef VECTOR_BLF_USE_IO_URING
+    if (m_ioUringReader) {
+        m_ioUringReader->read(position, m_buffer, m_bufferSize);
+        m_bufferPosition = position;
+        return m_position < m_bufferPosition + static_cast<std::streamoff>(m_bufferSize);
+    }
+#endif
+    ssize_t size;
+    do {
+        size = ::pread(m_fd, m_buffer, m_bufferCapacity, static_cast<off_t>(position));
+    } while ((size < 0) && (errno == EINTR));
+    m_bufferPosition = position;
+    m_bufferSize = (size > 0) ? static_cast<std::size_t>(size) : 0;
+
+    /* let the kernel read the following data in the background */
+#ifdef POSIX_FADV_WILLNEED
+    if (m_bufferSize == m_bufferCapacity)
+        ::posix_fadvise(m_fd, position + static_cast<std::streamoff>(m_bufferCapacity), static_cast<off_t>(m_bufferCapacity), POSIX_FADV_WILLNEED);
+#endif
+
+    return m_position < m_bufferPosition + static_cast<std::streamoff>(m_bufferSize);
+}
+#endif
+
 }
 }
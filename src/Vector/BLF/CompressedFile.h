@@ -6,19 +6,36 @@
 
 #include "platform.h"
 
+#include <cstddef>
 #include <fstream>
 #include <mutex>
+#include <string>
 
 #include "AbstractFile.h"
+#include "Metrics.h"
 
 #include "vector_blf_export.h"
 
 namespace Vector {
 namespace BLF {
 
+#ifndef _WIN32
+class IoUringReader;
+#endif
+
 /**
  * CompressedFile (Input/output file stream)
  *
+ * On POSIX systems, a file descriptor is used. Reads go through a large
+ * aligned read-ahead buffer. This reads several LogContainers at once,
+ * instead of a header and a payload read per LogContainer. Writes are not
+ * buffered, and writeGather issues a single writev. On Windows, std::fstream
+ * is used.
+ *
+ * If built with OPTION_USE_IO_URING, readAheadDepth buffers are read
+ * asynchronously with io_uring on Linux. If the kernel doesn't provide
+ * io_uring, the buffer is read synchronously.
+ *
  * This class is thread-safe.
  */
 class VECTOR_BLF_EXPORT CompressedFile final : public AbstractFile {
@@ -30,11 +47,42 @@ class VECTOR_BLF_EXPORT CompressedFile final : public AbstractFile {
     CompressedFile(CompressedFile &&) = delete;
     CompressedFile & operator=(CompressedFile &&) = delete;
 
+    /**
+     * Size of the read-ahead buffer in bytes.
+     *
+     * This is rounded up to a multiple of the alignment. It takes effect
+     * on the next open.
+     */
+    std::size_t readAheadSize {0x100000};
+
+    /**
+     * Number of read-ahead buffers, that are read in parallel.
+     *
+     * This is only used with io_uring. It takes effect on the next open.
+     */
+    unsigned int readAheadDepth {4};
+
+    /**
+     * Open files for reading only with O_DIRECT.
+     *
+     * The page cache is bypassed, so that huge sequential scans don't evict
+     * other data from it. If the file system doesn't support O_DIRECT, the
+     * file is opened without it.
+     */
+    bool directIo {false};
+
+    /**
+     * Drop data from the page cache, after it is copied into the read-ahead
+     * buffer.
+     */
+    bool dropPageCache {false};
+
     std::streamsize gcount() const override;
     void read(char * s, std::streamsize n) override;
     std::streampos tellg() override;
     void seekg(std::streamoff off, const std::ios_base::seekdir way = std::ios_base::cur) override;
     void write(const char * s, std::streamsize n) override;
+    void writeGather(const WriteBuffer * buffers, std::size_t count) override;
     std::streampos tellp() override;
     bool good() const override;
     bool eof() const override;
@@ -59,6 +107,36 @@ class VECTOR_BLF_EXPORT CompressedFile final : public AbstractFile {
      */
     virtual void close();
 
+    /**
+     * Flush buffered data to the operating system.
+     */
+    virtual void flush();
+
+    /**
+     * Flush buffered data and sync it to disk.
+     */
+    virtual void sync();
+
+    /**
+     * Truncate the file, which must be opened for writing.
+     *
+     * @param[in] size file size
+     */
+    virtual void truncate(std::streampos size);
+
+    /**
+     * Reset error state flags.
+     */
+    virtual void clear();
+
+    /**
+     * Discard the read-ahead data.
+     *
+     * The next read gets the data from the file again, including data
+     * that was appended in the meantime.
+     */
+    virtual void discardReadAhead();
+
     /**
      * Set position in output sequence.
      *
@@ -66,14 +144,100 @@ class VECTOR_BLF_EXPORT CompressedFile final : public AbstractFile {
      */
     virtual void seekp(std::streampos pos);
 
+    /**
+     * Get the number of reads, bytes read and time blocked in read.
+     *
+     * They are only collected with OPTION_USE_METRICS.
+     *
+     * @return metrics
+     */
+    virtual StageMetrics readMetrics() const;
+
   private:
     /**
      * file stream
      */
     std::fstream m_file {};
 
+    /**
+     * file name
+     */
+    std::string m_filename {};
+
     /** mutex */
     mutable std::mutex m_mutex {};
+
+    /** read metrics, collected with OPTION_USE_METRICS */
+    StageCounters m_readCounters {};
+
+    /**
+     * Read data, without metrics.
+     *
+     * @param[out] s data
+     * @param[in] n size of data
+     */
+    void readData(char * s, std::streamsize n);
+
+#ifndef _WIN32
+    /** file descriptor */
+    int m_fd {-1};
+
+    /** read-ahead buffer, aligned for O_DIRECT, if opened for reading */
+    char * m_buffer {nullptr};
+
+    /** capacity of read-ahead buffer */
+    std::size_t m_bufferCapacity {};
+
+    /** file position of read-ahead buffer */
+    std::streamoff m_bufferPosition {};
+
+    /** number of valid bytes in read-ahead buffer */
+    std::size_t m_bufferSize {};
+
+    /** file position */
+    std::streamoff m_position {};
+
+    /** asynchronous reader, if io_uring is used */
+    IoUringReader * m_ioUringReader {nullptr};
+
+    /** number of bytes read by last read */
+    std::streamsize m_gcount {};
+
+    /** end of file reached */
+    bool m_eof {false};
+
+    /** operation failed */
+    bool m_fail {false};
+
+    /** opened with app, so writes go to the end of file */
+    bool m_append {false};
+
+    /**
+     * Open file descriptor.
+     *
+     * On failure m_fd stays negative. Files opened for reading only then
+     * use std::fstream instead.
+     *
+     * @param[in] filename file name
+     * @param[in] openMode open in read or write mode
+     */
+    void openDescriptor(const char * filename, std::ios_base::openmode openMode);
+
+    /**
+     * Write data blocks at the current position.
+     *
+     * @param[in] buffers data blocks
+     * @param[in] count number of data blocks
+     */
+    void writeDescriptor(const WriteBuffer * buffers, std::size_t count);
+
+    /**
+     * Fill read-ahead buffer with the data at the current position.
+     *
+     * @return false on end of file or error
+     */
+    bool fillBuffer();
+#endif
 };
 
 }
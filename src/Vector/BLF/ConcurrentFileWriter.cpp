@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ConcurrentFileWriter.h"
+
+#include <queue>
+
+#include "Exceptions.h"
+#include "ObjectDispatch.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Lock-free ring buffer with a single producer and a single consumer.
+ */
+class StagingBuffer final {
+  public:
+    /**
+     * @param[in] size minimum number of objects
+     */
+    explicit StagingBuffer(std::size_t size) {
+        std::size_t capacity = 2;
+        while (capacity < size)
+            capacity <<= 1;
+        m_objects.resize(capacity);
+        m_mask = capacity - 1;
+    }
+
+    ~StagingBuffer() {
+        while (ObjectHeaderBase * ohb = pop())
+            delete ohb;
+    }
+
+    /**
+     * Enqueue object. Only called by the producer.
+     *
+     * @param[in] ohb object
+     * @return false if the buffer is full
+     */
+    bool push(ObjectHeaderBase * ohb) {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_objects.size())
+            return false;
+        m_objects[tail & m_mask] = ohb;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Dequeue object. Only called by the consumer.
+     *
+     * @return object or nullptr if the buffer is empty
+     */
+    ObjectHeaderBase * pop() {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return nullptr;
+        ObjectHeaderBase * ohb = m_objects[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return ohb;
+    }
+
+  private:
+    /** objects */
+    std::vector<ObjectHeaderBase *> m_objects {};
+
+    /** capacity - 1 */
+    std::size_t m_mask {};
+
+    /** read position, written by the consumer */
+    std::atomic<std::size_t> m_head {0};
+
+    /** keep head and tail in different cache lines */
+    char m_padding[64] {};
+
+    /** write position, written by the producer */
+    std::atomic<std::size_t> m_tail {0};
+};
+
+/** object waiting in the merge thread */
+struct StagedObject {
+    /** object timestamp in nanoseconds */
+    uint64_t timeStamp;
+
+    /** order of arrival, for objects with the same timestamp */
+    uint64_t sequence;
+
+    /** time of arrival */
+    std::chrono::steady_clock::time_point arrival;
+
+    /** object */
+    ObjectHeaderBase * ohb;
+};
+
+/** order of StagedObjects in the heap, earliest on top */
+struct StagedObjectLater {
+    bool operator()(const StagedObject & a, const StagedObject & b) const {
+        if (a.timeStamp != b.timeStamp)
+            return a.timeStamp > b.timeStamp;
+        return a.sequence > b.sequence;
+    }
+};
+
+/**
+ * Counts a producer in ConcurrentFileWriter::write.
+ *
+ * The counter is incremented before m_closed is checked. As both are
+ * sequentially consistent, close either sees the producer, or the producer
+ * sees m_closed.
+ */
+class ProducerGuard final {
+  public:
+    /**
+     * @param[in] producerCount number of producers
+     */
+    explicit ProducerGuard(std::atomic<uint32_t> & producerCount) :
+        m_producerCount(producerCount) {
+        m_producerCount++;
+    }
+
+    ~ProducerGuard() {
+        m_producerCount--;
+    }
+
+  private:
+    /** number of producers */
+    std::atomic<uint32_t> & m_producerCount;
+};
+
+/** source of ConcurrentFileWriter::m_id */
+static std::atomic<uint64_t> nextConcurrentFileWriterId {1};
+
+ConcurrentFileWriter::ConcurrentFileWriter(File & file) :
+    m_file(file),
+    m_id(nextConcurrentFileWriterId++) {
+}
+
+ConcurrentFileWriter::~ConcurrentFileWriter() {
+    try {
+        close();
+    } catch (const std::exception &) {
+        /* ignore exceptions of merge thread in destructor */
+    }
+}
+
+void ConcurrentFileWriter::write(ObjectHeaderBase * ohb) {
+    /* close waits until the object is pushed */
+    ProducerGuard producerGuard(m_producerCount);
+
+    /* check */
+    StagingBuffer * buffer = m_closed ? nullptr : stagingBuffer();
+    if (!buffer) {
+        delete ohb;
+        throw Exception("ConcurrentFileWriter::write(): Writer is closed.");
+    }
+
+    /* wait for the merge thread, if the staging buffer is full */
+    while (!buffer->push(ohb)) {
+        if (!m_mergeThreadRunning) {
+            delete ohb;
+            throw Exception("ConcurrentFileWriter::write(): Merge thread stopped.");
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ConcurrentFileWriter::close() {
+    /* no further producers */
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+
+    /* wait for producers, that passed the check before */
+    while (m_producerCount > 0)
+        std::this_thread::yield();
+
+    /* finalize merge thread */
+    m_mergeThreadRunning = false;
+    if (m_mergeThread.joinable())
+        m_mergeThread.join();
+
+    /* forward exception of merge thread */
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto & stagingBuffer : m_stagingBuffers)
+        delete stagingBuffer.second;
+    m_stagingBuffers.clear();
+    if (m_mergeThreadException) {
+        std::exception_ptr mergeThreadException = m_mergeThreadException;
+        m_mergeThreadException = nullptr;
+        std::rethrow_exception(mergeThreadException);
+    }
+}
+
+uint64_t ConcurrentFileWriter::lateObjectCount() const {
+    return m_lateObjectCount;
+}
+
+StagingBuffer * ConcurrentFileWriter::stagingBuffer() {
+    /* staging buffer of the last writer used by this thread */
+    static thread_local struct {
+        uint64_t id;
+        StagingBuffer * buffer;
+    } cache {0, nullptr};
+    if (cache.id == m_id)
+        return cache.buffer;
+
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_closed)
+        return nullptr;
+
+    /* create staging buffer */
+    StagingBuffer * & buffer = m_stagingBuffers[std::this_thread::get_id()];
+    if (!buffer)
+        buffer = new StagingBuffer(stagingBufferSize);
+
+    /* start merge thread */
+    if (!m_mergeThread.joinable()) {
+        m_mergeThreadRunning = true;
+        m_mergeThread = std::thread(mergeThread, this);
+    }
+
+    cache.id = m_id;
+    cache.buffer = buffer;
+    return buffer;
+}
+
+void ConcurrentFileWriter::mergeThread(ConcurrentFileWriter * concurrentFileWriter) {
+    std::priority_queue<StagedObject, std::vector<StagedObject>, StagedObjectLater> heap;
+    std::vector<StagingBuffer *> buffers;
+    std::vector<ObjectHeaderBase *> batch;
+    try {
+        const uint64_t window = static_cast<uint64_t>(concurrentFileWriter->reorderWindow.count());
+        uint64_t sequence = 0;
+        uint64_t maxTimeStamp = 0; // latest staged timestamp
+        uint64_t lastTimeStamp = 0; // latest written timestamp
+        for (;;) {
+            /* everything staged before close is drained in this pass */
+            bool running = concurrentFileWriter->m_mergeThreadRunning;
+
+            /* get staging buffers */
+            {
+                std::lock_guard<std::mutex> lock(concurrentFileWriter->m_mutex);
+                buffers.clear();
+                for (const auto & stagingBuffer : concurrentFileWriter->m_stagingBuffers)
+                    buffers.push_back(stagingBuffer.second);
+            }
+
+            /* drain staging buffers */
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            for (StagingBuffer * buffer : buffers) {
+                while (ObjectHeaderBase * ohb = buffer->pop()) {
+                    StagedObject stagedObject;
+                    stagedObject.timeStamp = objectTimeStampNs(*ohb);
+                    stagedObject.sequence = sequence++;
+                    stagedObject.arrival = now;
+                    stagedObject.ohb = ohb;
+                    heap.push(stagedObject);
+                    if (stagedObject.timeStamp > maxTimeStamp)
+                        maxTimeStamp = stagedObject.timeStamp;
+                }
+            }
+
+            /* take objects, that are out of the reorder window */
+            while (!heap.empty()) {
+                const StagedObject & stagedObject = heap.top();
+                bool due =
+                    !running ||
+                    (stagedObject.timeStamp + window <= maxTimeStamp) ||
+                    (now - stagedObject.arrival >= concurrentFileWriter->reorderWindow);
+                if (!due)
+                    break;
+                if (stagedObject.timeStamp < lastTimeStamp)
+                    concurrentFileWriter->m_lateObjectCount++;
+                else
+                    lastTimeStamp = stagedObject.timeStamp;
+                batch.push_back(stagedObject.ohb);
+                heap.pop();
+            }
+
+            /* write */
+            if (!batch.empty()) {
+                concurrentFileWriter->m_file.write(batch.data(), batch.size());
+                batch.clear();
+            }
+
+            if (!running)
+                break;
+            std::this_thread::sleep_for(concurrentFileWriter->pollInterval);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(concurrentFileWriter->m_mutex);
+        concurrentFileWriter->m_mergeThreadException = std::current_exception();
+        concurrentFileWriter->m_mergeThreadRunning = false;
+
+        /* delete objects, that were not written */
+        for (ObjectHeaderBase * ohb : batch)
+            delete ohb;
+        while (!heap.empty()) {
+            delete heap.top().ohb;
+            heap.pop();
+        }
+    }
+}
+
+}
+}
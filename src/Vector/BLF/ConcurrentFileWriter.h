@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "File.h"
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+class StagingBuffer;
+
+/**
+ * Writes objects of several producer threads into one file.
+ *
+ * Each producer thread gets its own lock-free staging buffer on its first
+ * write, so producers don't contend with each other. A merge thread drains
+ * the staging buffers and writes the objects into the file in
+ * non-decreasing timestamp order. An object is held back until an object
+ * that is reorderWindow later was staged, or until it was held back for
+ * reorderWindow. Objects, that arrive after a later object was already
+ * written, are written immediately and counted as late.
+ *
+ * The file has to be opened for writing before, and closed after close().
+ */
+class VECTOR_BLF_EXPORT ConcurrentFileWriter final {
+  public:
+    /**
+     * @param[in] file file opened for writing
+     */
+    explicit ConcurrentFileWriter(File & file);
+    virtual ~ConcurrentFileWriter();
+
+    /**
+     * Maximum timestamp disorder between producers, that is sorted.
+     *
+     * Set before the first write.
+     */
+    std::chrono::nanoseconds reorderWindow {std::chrono::milliseconds(100)};
+
+    /**
+     * Number of objects per staging buffer.
+     *
+     * A producer waits if its staging buffer is full.
+     * Set before the first write.
+     */
+    std::size_t stagingBufferSize {0x1000};
+
+    /**
+     * Interval, in which the merge thread looks for new objects.
+     *
+     * Set before the first write.
+     */
+    std::chrono::microseconds pollInterval {1000};
+
+    /**
+     * Write object.
+     *
+     * This method can be called from several threads concurrently.
+     *
+     * @param[in] ohb write object (ownership is taken)
+     */
+    virtual void write(ObjectHeaderBase * ohb);
+
+    /**
+     * Write all staged objects into the file and stop the merge thread.
+     *
+     * Waits for producers, that are still in write(). No further objects
+     * can be written afterwards. The file itself is not closed.
+     */
+    virtual void close();
+
+    /**
+     * Number of objects, that were written out of order, because they
+     * arrived after the reorder window.
+     *
+     * @return number of late objects
+     */
+    virtual uint64_t lateObjectCount() const;
+
+  private:
+    /** file */
+    File & m_file;
+
+    /** unique id to identify this writer in the producer threads */
+    const uint64_t m_id;
+
+    /** staging buffers per producer thread (owned) */
+    std::map<std::thread::id, StagingBuffer *> m_stagingBuffers {};
+
+    /** mutex for m_stagingBuffers and the merge thread state */
+    mutable std::mutex m_mutex {};
+
+    /** merge thread */
+    std::thread m_mergeThread {};
+
+    /** merge thread still running */
+    std::atomic<bool> m_mergeThreadRunning {false};
+
+    /** writer closed */
+    std::atomic<bool> m_closed {false};
+
+    /** number of producers in write(), that close() waits for */
+    std::atomic<uint32_t> m_producerCount {0};
+
+    /** exception in merge thread */
+    std::exception_ptr m_mergeThreadException {};
+
+    /** number of late objects */
+    std::atomic<uint64_t> m_lateObjectCount {0};
+
+    /**
+     * Get the staging buffer of the calling thread.
+     *
+     * The buffer is created on first use, and the merge thread started.
+     *
+     * @return staging buffer
+     */
+    StagingBuffer * stagingBuffer();
+
+    /**
+     * Merge the staging buffers into the file.
+     *
+     * @param[in] concurrentFileWriter concurrent file writer
+     */
+    static void mergeThread(ConcurrentFileWriter * concurrentFileWriter);
+};
+
+}
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Coroutines.h"
+
+#if defined(VECTOR_BLF_USE_COROUTINES) && defined(__cpp_impl_coroutine)
+
+namespace Vector {
+namespace BLF {
+
+Generator<std::unique_ptr<ObjectHeaderBase>> objectStream(File & file, std::size_t batchSize) {
+    ObjectBatch batch(file, batchSize);
+    while (ObjectHeaderBase * ohb = batch.next()) {
+        std::unique_ptr<ObjectHeaderBase> object(ohb);
+        co_yield object;
+    }
+}
+
+ReadBatch::ReadBatch(File & file, std::size_t count, Resume resume) :
+    m_file(file),
+    m_count(count > 0 ? count : 1),
+    m_resume(std::move(resume)) {
+}
+
+bool ReadBatch::await_ready() {
+    return tryRead();
+}
+
+bool ReadBatch::await_suspend(std::coroutine_handle<> handle) {
+    /* the function is called by a File thread, or not at all */
+    Resume resume = m_resume;
+    auto function = [handle, resume]() {
+        if (resume)
+            resume(handle);
+        else
+            handle.resume();
+    };
+    if (m_file.callWhenReadable(function))
+        return true;
+
+    /* objects or eof became available in the meantime */
+    return !tryRead();
+}
+
+std::vector<std::unique_ptr<ObjectHeaderBase>> ReadBatch::await_resume() {
+    /* objects were not taken yet, if resumed by the File thread */
+    if (m_objects.empty())
+        tryRead();
+
+    std::vector<std::unique_ptr<ObjectHeaderBase>> objects;
+    objects.reserve(m_objects.size());
+    for (ObjectHeaderBase * ohb : m_objects)
+        objects.emplace_back(ohb);
+    m_objects.clear();
+    return objects;
+}
+
+bool ReadBatch::tryRead() {
+    m_objects.resize(m_count);
+    m_objects.resize(m_file.tryRead(m_objects.data(), m_objects.size()));
+    return !m_objects.empty() || m_file.eof();
+}
+
+ReadBatch readBatch(File & file, std::size_t count, ReadBatch::Resume resume) {
+    return ReadBatch(file, count, std::move(resume));
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,349 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+/* only available in C++20 builds with OPTION_USE_COROUTINES */
+#if defined(VECTOR_BLF_USE_COROUTINES) && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "File.h"
+#include "ObjectDispatch.h"
+#include "ObjectHeaderBase.h"
+#include "ObjectRange.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Lazy sequence of values, that are produced by a coroutine with co_yield.
+ *
+ * This is a minimal replacement for C++23 std::generator. The generator can
+ * only be iterated once.
+ *
+ * @tparam T value type
+ */
+template <typename T>
+class Generator final {
+  public:
+    /** promise of the coroutine */
+    struct promise_type {
+        /** current value */
+        T * m_value {nullptr};
+
+        /** exception thrown by the coroutine */
+        std::exception_ptr m_exception {};
+
+        /** @return generator */
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        /** @return start on first iteration */
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        /** @return keep frame, until generator is destroyed */
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        /**
+         * Pass value to the consumer.
+         *
+         * @param[in] value value
+         * @return suspend until next iteration
+         */
+        std::suspend_always yield_value(T & value) noexcept {
+            m_value = std::addressof(value);
+            return {};
+        }
+
+        /**
+         * Pass temporary value to the consumer.
+         *
+         * The value lives until the coroutine is resumed.
+         *
+         * @param[in] value value
+         * @return suspend until next iteration
+         */
+        std::suspend_always yield_value(T && value) noexcept {
+            m_value = std::addressof(value);
+            return {};
+        }
+
+        /** end of sequence */
+        void return_void() noexcept {
+        }
+
+        /** keep exception, to rethrow it in the consumer */
+        void unhandled_exception() {
+            m_exception = std::current_exception();
+        }
+    };
+
+    /** input iterator */
+    class iterator final {
+      public:
+        /** iterator category */
+        using iterator_category = std::input_iterator_tag;
+
+        /** value type */
+        using value_type = T;
+
+        /** difference type */
+        using difference_type = std::ptrdiff_t;
+
+        /** pointer */
+        using pointer = T *;
+
+        /** reference */
+        using reference = T &;
+
+        /** end iterator */
+        iterator() = default;
+
+        /**
+         * Iterator at the current value of a coroutine.
+         *
+         * @param[in] handle coroutine handle
+         */
+        explicit iterator(std::coroutine_handle<promise_type> handle) :
+            m_handle(handle) {
+        }
+
+        /** @return current value */
+        reference operator*() const {
+            return *m_handle.promise().m_value;
+        }
+
+        /** @return current value */
+        pointer operator->() const {
+            return m_handle.promise().m_value;
+        }
+
+        /** @return iterator at the next value */
+        iterator & operator++() {
+            m_handle.resume();
+            if (m_handle.done()) {
+                std::coroutine_handle<promise_type> handle = m_handle;
+                m_handle = nullptr;
+                rethrow(handle);
+            }
+            return *this;
+        }
+
+        /** go to next value */
+        void operator++(int) {
+            ++*this;
+        }
+
+        /** @return true if both are at the same coroutine, or both at the end */
+        bool operator==(const iterator & other) const {
+            return m_handle == other.m_handle;
+        }
+
+        /** @return false if both are at the same coroutine, or both at the end */
+        bool operator!=(const iterator & other) const {
+            return m_handle != other.m_handle;
+        }
+
+      private:
+        /** coroutine or nullptr at the end */
+        std::coroutine_handle<promise_type> m_handle {};
+    };
+
+    /**
+     * Constructor
+     *
+     * @param[in] handle coroutine handle
+     */
+    explicit Generator(std::coroutine_handle<promise_type> handle) :
+        m_handle(handle) {
+    }
+
+    virtual ~Generator() {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    Generator(const Generator &) = delete;
+    Generator & operator=(const Generator &) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param[in] other other generator
+     */
+    Generator(Generator && other) noexcept :
+        m_handle(std::exchange(other.m_handle, nullptr)) {
+    }
+
+    /**
+     * Move assignment
+     *
+     * @param[in] other other generator
+     * @return this generator
+     */
+    Generator & operator=(Generator && other) noexcept {
+        if (this != &other) {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    /** @return iterator at the first value */
+    iterator begin() {
+        if (!m_handle || m_handle.done())
+            return iterator();
+        m_handle.resume();
+        if (m_handle.done()) {
+            rethrow(m_handle);
+            return iterator();
+        }
+        return iterator(m_handle);
+    }
+
+    /** @return end iterator */
+    iterator end() {
+        return iterator();
+    }
+
+  private:
+    /** coroutine */
+    std::coroutine_handle<promise_type> m_handle {};
+
+    /**
+     * Rethrow the exception of a finished coroutine.
+     *
+     * @param[in] handle coroutine handle
+     */
+    static void rethrow(std::coroutine_handle<promise_type> handle) {
+        if (handle.promise().m_exception)
+            std::rethrow_exception(handle.promise().m_exception);
+    }
+};
+
+/**
+ * Stream of all objects of a file, e.g. for (auto & ohb : objectStream(file)).
+ *
+ * The objects are read in batches of up to batchSize. The current object
+ * can be moved out to keep it, otherwise it's deleted on the next iteration.
+ *
+ * @param[in] file file opened for reading
+ * @param[in] batchSize maximum number of objects per batch
+ * @return generator of std::unique_ptr<ObjectHeaderBase>
+ */
+VECTOR_BLF_EXPORT Generator<std::unique_ptr<ObjectHeaderBase>> objectStream(File & file, std::size_t batchSize = 256);
+
+/**
+ * Stream of the objects of a file, that are instances of T.
+ *
+ * Other objects are deleted while reading.
+ *
+ * @see objectStream
+ *
+ * @tparam T object class
+ * @param[in] file file opened for reading
+ * @param[in] batchSize maximum number of objects per batch
+ * @return generator of std::unique_ptr<T>
+ */
+template <typename T>
+Generator<std::unique_ptr<T>> typedObjectStream(File & file, std::size_t batchSize = 256) {
+    ObjectBatch batch(file, batchSize);
+    while (ObjectHeaderBase * ohb = batch.next()) {
+        std::unique_ptr<ObjectHeaderBase> object(ohb);
+        if (isInstanceOf<T>(object->objectType)) {
+            std::unique_ptr<T> typedObject(static_cast<T *>(object.release()));
+            co_yield typedObject;
+        }
+    }
+}
+
+/**
+ * Awaitable, that reads a batch of objects from a file.
+ *
+ * Instead of blocking the thread on the read queue, the awaiting coroutine
+ * is suspended, until the File threads decoded some objects. It's resumed
+ * by the resume function, which usually posts it to an executor.
+ */
+class VECTOR_BLF_EXPORT ReadBatch final {
+  public:
+    /** function, that resumes a suspended coroutine */
+    using Resume = std::function<void(std::coroutine_handle<>)>;
+
+    /**
+     * Constructor
+     *
+     * @param[in] file file opened for reading
+     * @param[in] count maximum number of objects
+     * @param[in] resume resume function. If it's empty, the coroutine is
+     *   resumed directly in the File thread.
+     */
+    ReadBatch(File & file, std::size_t count, Resume resume);
+
+    /** @return true if objects or eof are available without waiting */
+    bool await_ready();
+
+    /**
+     * Suspend until objects or eof are available.
+     *
+     * @param[in] handle awaiting coroutine
+     * @return false if objects or eof became available in the meantime
+     */
+    bool await_suspend(std::coroutine_handle<> handle);
+
+    /** @return objects, or no objects at eof */
+    std::vector<std::unique_ptr<ObjectHeaderBase>> await_resume();
+
+  private:
+    /** file */
+    File & m_file;
+
+    /** maximum number of objects */
+    std::size_t m_count;
+
+    /** resume function */
+    Resume m_resume;
+
+    /** objects read so far */
+    std::vector<ObjectHeaderBase *> m_objects {};
+
+    /**
+     * Try to read objects.
+     *
+     * @return true if objects or eof are available
+     */
+    bool tryRead();
+};
+
+/**
+ * Read a batch of objects, e.g. auto objects = co_await readBatch(file).
+ *
+ * @param[in] file file opened for reading
+ * @param[in] count maximum number of objects
+ * @param[in] resume resume function
+ * @return awaitable
+ */
+VECTOR_BLF_EXPORT ReadBatch readBatch(File & file, std::size_t count = 256, ReadBatch::Resume resume = ReadBatch::Resume());
+
+}
+}
+
+#endif
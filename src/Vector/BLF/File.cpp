@@ -4,18 +4,32 @@
 
 #include "File.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #include "Exceptions.h"
+#include "ObjectDispatch.h"
 
 namespace Vector {
 namespace BLF {
 
+#ifdef VECTOR_BLF_USE_METRICS
+/** number of object types, for which decode metrics are collected */
+static const std::size_t decodeCounterCount = static_cast<std::size_t>(ObjectType::ATTRIBUTE_EVENT) + 1;
+#endif
+
 File::File() {
     /* set performance/memory values */
     m_readWriteQueue.setBufferSize(10);
     m_uncompressedFile.setBufferSize(m_uncompressedFile.defaultLogContainerSize());
+
+#ifdef VECTOR_BLF_USE_METRICS
+    /* metrics */
+    m_decodeCounters.reset(new StageCounters[decodeCounterCount]);
+#endif
 }
 
 File::~File() {
@@ -27,6 +41,12 @@ void File::open(const char * filename, const std::ios_base::openmode mode) {
     if (is_open())
         return;
 
+    /* append */
+    if (mode & std::ios_base::app) {
+        openAppend(filename);
+        return;
+    }
+
     /* try to open file */
     m_compressedFile.open(filename, mode | std::ios_base::binary);
     if (!m_compressedFile.is_open())
@@ -38,12 +58,23 @@ void File::open(const char * filename, const std::ios_base::openmode mode) {
         /* read file statistics */
         fileStatistics.read(m_compressedFile);
 
+        /* identify file version for the cache */
+        if (logContainerCache)
+            m_fileIdentity = LogContainerCache::fileIdentity(filename);
+
         /* read restore points */
         // @todo read restore points
 
         /* fileStatistics done */
         currentUncompressedFileSize += fileStatistics.statisticsSize;
 
+        /* progress */
+        m_compressedBytesRead = static_cast<uint64_t>(m_compressedFile.tellg());
+        m_logContainersRead = 0;
+        m_readObjectTimeStamp = 0;
+        m_lastProgressCallback = std::chrono::steady_clock::now();
+        m_cancelled = false;
+
         /* prepare threads */
         m_uncompressedFileThreadRunning = true;
         m_compressedFileThreadRunning = true;
@@ -51,15 +82,36 @@ void File::open(const char * filename, const std::ios_base::openmode mode) {
         /* create read threads */
         m_uncompressedFileThread = std::thread(uncompressedFileReadThread, this);
         m_compressedFileThread = std::thread(compressedFileReadThread, this);
+
+        /* cancellation */
+        if (cancellationToken) {
+            m_registeredCancellationToken = cancellationToken;
+            m_cancellationTokenId = m_registeredCancellationToken->registerFunction([this]() {
+                cancel();
+            });
+        }
     } else
 
         /* write */
         if (mode & std::ios_base::out) {
+            /* measurement starts now, if not given */
+            if (fileStatistics.measurementStartTime.year == 0)
+                fileStatistics.measurementStartTime = currentSystemTime();
+            m_lastObjectTimeStamp = 0;
+            m_restorePoints.restorePoints.clear();
+            m_pendingRestorePoints.clear();
+
             /* write file statistics */
             fileStatistics.write(m_compressedFile);
 
             /* fileStatistics done */
             currentUncompressedFileSize += fileStatistics.statisticsSize;
+            currentCompressedFileSize = static_cast<uint64_t>(m_compressedFile.tellp());
+            m_compressedObjectsSize = 0;
+
+            /* checkpoints */
+            m_lastCheckpointTime = std::chrono::steady_clock::now();
+            m_lastCheckpointPosition = m_compressedFile.tellp();
 
             /* prepare threads */
             m_uncompressedFileThreadRunning = true;
@@ -71,6 +123,121 @@ void File::open(const char * filename, const std::ios_base::openmode mode) {
         }
 }
 
+void File::openAppend(const char * filename) {
+    /* try to open an existing file without truncating it */
+    m_compressedFile.open(filename, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    if (!m_compressedFile.is_open()) {
+        /* start a new file */
+        open(filename, std::ios_base::out);
+        return;
+    }
+
+    /* start a new file, if the existing one is empty */
+    m_compressedFile.seekg(0, std::ios_base::end);
+    std::streampos fileSize = m_compressedFile.tellg();
+    m_compressedFile.seekg(0, std::ios_base::beg);
+    if (fileSize == 0) {
+        m_compressedFile.close();
+        open(filename, std::ios_base::out);
+        return;
+    }
+
+    /* read file statistics, and leave the file untouched, if it's no BLF file */
+    FileStatistics existingFileStatistics;
+    try {
+        existingFileStatistics.read(m_compressedFile);
+        if (!m_compressedFile.good())
+            throw Exception("File::open(): File statistics are incomplete.");
+    } catch (Exception &) {
+        m_compressedFile.close();
+        throw;
+    }
+    fileStatistics = existingFileStatistics;
+    m_openMode = std::ios_base::out | std::ios_base::app;
+    currentUncompressedFileSize += fileStatistics.statisticsSize;
+    currentObjectCount = fileStatistics.objectCount;
+    m_lastObjectTimeStamp = 0;
+    if ((fileStatistics.measurementStartTime.year != 0) && (fileStatistics.lastObjectTime.year != 0)) {
+        int64_t lastObjectTimeStamp = systemTimeToNs(fileStatistics.lastObjectTime) - systemTimeToNs(fileStatistics.measurementStartTime);
+        if (lastObjectTimeStamp > 0)
+            m_lastObjectTimeStamp = static_cast<uint64_t>(lastObjectTimeStamp);
+    }
+
+    /* continue after the last complete LogContainer with objects */
+    std::streampos endOfObjects = endOfLastLogContainer();
+
+    /* existing restore points are overwritten, and written again at close */
+    m_restorePoints.restorePoints.clear();
+    m_pendingRestorePoints.clear();
+    if ((fileStatistics.restorePointsOffset != 0) &&
+            (static_cast<uint64_t>(endOfObjects) == fileStatistics.restorePointsOffset) &&
+            readRestorePointContainers(endOfObjects))
+        restorePointInterval = m_restorePoints.objectInterval;
+    fileStatistics.restorePointsOffset = 0;
+    m_compressedFile.seekp(endOfObjects);
+    currentCompressedFileSize = static_cast<uint64_t>(m_compressedFile.tellp());
+    m_compressedObjectsSize = 0;
+
+    /* checkpoints */
+    m_lastCheckpointTime = std::chrono::steady_clock::now();
+    m_lastCheckpointPosition = m_compressedFile.tellp();
+    m_checkpointObjectCount = currentObjectCount;
+
+    /* prepare threads */
+    m_uncompressedFileThreadRunning = true;
+    m_compressedFileThreadRunning = true;
+
+    /* create write threads */
+    m_uncompressedFileThread = std::thread(uncompressedFileWriteThread, this);
+    m_compressedFileThread = std::thread(compressedFileWriteThread, this);
+}
+
+std::streampos File::endOfLastLogContainer() {
+    /* get end of file */
+    m_compressedFile.seekg(0, std::ios_base::end);
+    std::streampos endOfFile = m_compressedFile.tellg();
+
+    /* objects end at the restore points */
+    std::streampos endOfObjects = endOfFile;
+    if ((fileStatistics.restorePointsOffset != 0) &&
+            (static_cast<std::streamoff>(fileStatistics.restorePointsOffset) < endOfFile))
+        endOfObjects = static_cast<std::streamoff>(fileStatistics.restorePointsOffset);
+
+    /* walk over the LogContainer headers */
+    std::streampos position = fileStatistics.statisticsSize;
+    while (position < endOfObjects) {
+        m_compressedFile.seekg(position, std::ios_base::beg);
+        LogContainer logContainer;
+        try {
+            logContainer.readHeader(m_compressedFile);
+        } catch (Vector::BLF::Exception &) {
+            /* signature mismatch */
+            break;
+        }
+        if (!m_compressedFile.good() || (logContainer.objectType != ObjectType::LOG_CONTAINER))
+            break;
+
+        /* LogContainer is truncated */
+        std::streampos nextPosition = position +
+                                      static_cast<std::streamoff>(logContainer.objectSize) +
+                                      static_cast<std::streamoff>(logContainer.objectSize % 4);
+        if (nextPosition > endOfObjects)
+            break;
+
+        /* statistics */
+        currentUncompressedFileSize +=
+            logContainer.internalHeaderSize() +
+            logContainer.uncompressedFileSize;
+
+        position = nextPosition;
+    }
+
+    /* reset error state, as the walk might have stopped at eof */
+    m_compressedFile.clear();
+
+    return position;
+}
+
 void File::open(const std::string & filename, std::ios_base::openmode mode) {
     open(filename.c_str(), mode);
 }
@@ -94,11 +261,69 @@ ObjectHeaderBase * File::read() {
     return ohb;
 }
 
+ObjectHeaderBase * File::read(std::chrono::milliseconds timeout) {
+    /* read object */
+    ObjectHeaderBase * ohb = m_readWriteQueue.read(std::chrono::steady_clock::now() + timeout);
+
+    return ohb;
+}
+
+std::size_t File::read(ObjectHeaderBase ** objects, std::size_t count) {
+    /* read objects */
+    return m_readWriteQueue.read(objects, count);
+}
+
+std::size_t File::tryRead(ObjectHeaderBase ** objects, std::size_t count) {
+    /* read objects */
+    return m_readWriteQueue.tryRead(objects, count);
+}
+
+bool File::callWhenReadable(std::function<void()> function) {
+    return m_readWriteQueue.callWhenReadable(std::move(function));
+}
+
+ObjectRange<ObjectHeaderBase> File::objects(std::size_t batchSize) {
+    enlargeReadQueue(batchSize);
+    return ObjectRange<ObjectHeaderBase>(*this, batchSize);
+}
+
 void File::write(ObjectHeaderBase * ohb) {
     /* push to queue */
     m_readWriteQueue.write(ohb);
 }
 
+void File::write(std::vector<std::unique_ptr<ObjectHeaderBase>> && objects) {
+    /* take over ownership */
+    std::vector<ObjectHeaderBase *> ohbs;
+    ohbs.reserve(objects.size());
+    for (std::unique_ptr<ObjectHeaderBase> & object : objects)
+        if (object)
+            ohbs.push_back(object.release());
+    objects.clear();
+
+    /* push to queue */
+    write(ohbs.data(), ohbs.size());
+}
+
+void File::write(ObjectHeaderBase * const * objects, std::size_t count) {
+    /* push to queue */
+    if (count > 0)
+        m_readWriteQueue.write(objects, count);
+}
+
+uint64_t File::waitForCompressedObjects(uint64_t objectsSize) {
+    /* mutex lock */
+    std::unique_lock<std::mutex> lock(m_compressedObjectsMutex);
+
+    /* wait for compressedFileThread */
+    m_compressedObjectsChanged.wait(lock, [&] {
+        return
+            (m_compressedObjectsSize >= objectsSize) ||
+            !m_compressedFileThreadRunning;
+    });
+    return m_compressedObjectsSize;
+}
+
 void File::close() {
     /* check if file is open */
     if (!is_open())
@@ -106,6 +331,12 @@ void File::close() {
 
     /* read */
     if (m_openMode & std::ios_base::in) {
+        /* unregister from cancellationToken */
+        if (m_registeredCancellationToken) {
+            m_registeredCancellationToken->unregisterFunction(m_cancellationTokenId);
+            m_registeredCancellationToken.reset();
+        }
+
         /* finalize compressedFileThread */
         m_compressedFileThreadRunning = false;
         m_compressedFile.close();
@@ -156,25 +387,25 @@ void File::close() {
         /* write restore points */
         if (writeRestorePoints) {
             /* create a new log container for it */
-            m_uncompressedFile.nextLogContainer();
+            m_logContainerWriter.seal();
 
             /* set file size */
             fileStatistics.restorePointsOffset = static_cast<uint64_t>(m_compressedFile.tellp());
 
-            /* write end of file message */
-//            auto * unknown115 = new Unknown115;
-//            m_readWriteQueue.write(unknown115);
-
-            /* process once */
-            readWriteQueue2UncompressedFile();
-            uncompressedFile2CompressedFile();
+            /* write restore point containers */
+            writeRestorePointContainers();
         }
 
         /* set file statistics */
         fileStatistics.fileSize = static_cast<uint64_t>(m_compressedFile.tellp());
         fileStatistics.uncompressedFileSize = currentUncompressedFileSize;
         fileStatistics.objectCount = currentObjectCount;
-        // @todo fileStatistics.objectsRead = ?
+        setLastObjectTime();
+        // objectsRead of the BL API is a counter of the reader, and not stored in the file
+
+        /* drop the rest of an appended file, e.g. its former restore points */
+        if (m_openMode & std::ios_base::app)
+            m_compressedFile.truncate(m_compressedFile.tellp());
 
         /* write fileStatistics and close compressedFile */
         m_compressedFile.seekp(0);
@@ -183,552 +414,363 @@ void File::close() {
     }
 }
 
-uint32_t File::defaultLogContainerSize() const {
-    return m_uncompressedFile.defaultLogContainerSize();
+Metrics File::metrics() const {
+    Metrics metrics;
+#ifdef VECTOR_BLF_USE_METRICS
+    metrics.enabled = true;
+    metrics.compressedFileRead = m_compressedFile.readMetrics();
+    metrics.inflate = m_inflateCounters.metrics();
+    for (std::size_t i = 0; i < decodeCounterCount; i++) {
+        StageMetrics decode = m_decodeCounters[i].metrics();
+        if (decode.count > 0)
+            metrics.decode[static_cast<ObjectType>(i)] = decode;
+    }
+    metrics.uncompressedFile = m_uncompressedFile.metrics();
+    metrics.objectQueue = m_readWriteQueue.metrics();
+#endif
+    return metrics;
 }
 
-void File::setDefaultLogContainerSize(uint32_t defaultLogContainerSize) {
-    m_uncompressedFile.setDefaultLogContainerSize(defaultLogContainerSize);
+Progress File::progress() const {
+    Progress progress;
+    progress.compressedBytesRead = m_compressedBytesRead;
+    progress.compressedFileSize = fileStatistics.fileSize;
+    progress.logContainersRead = m_logContainersRead;
+    progress.objectsRead = currentObjectCount;
+    progress.objectTimeStamp = m_readObjectTimeStamp;
+    return progress;
 }
 
-ObjectHeaderBase * File::createObject(ObjectType type) {
-    ObjectHeaderBase * obj = nullptr;
-
-    switch (type) {
-    case ObjectType::UNKNOWN:
-        break;
-
-    case ObjectType::CAN_MESSAGE:
-        obj = new CanMessage();
-        break;
-
-    case ObjectType::CAN_ERROR:
-        obj = new CanErrorFrame();
-        break;
-
-    case ObjectType::CAN_OVERLOAD:
-        obj = new CanOverloadFrame();
-        break;
-
-    case ObjectType::CAN_STATISTIC:
-        obj = new CanDriverStatistic();
-        break;
-
-    case ObjectType::APP_TRIGGER:
-        obj = new AppTrigger();
-        break;
-
-    case ObjectType::ENV_INTEGER:
-    case ObjectType::ENV_DOUBLE:
-    case ObjectType::ENV_STRING:
-    case ObjectType::ENV_DATA:
-        obj = new EnvironmentVariable();
-        break;
-
-    case ObjectType::LOG_CONTAINER:
-        obj = new LogContainer();
-        break;
-
-        /*
-    case ObjectType::LIN_MESSAGE:
-        obj = new LinMessage();
-        break;
-
-    case ObjectType::LIN_CRC_ERROR:
-        obj = new LinCrcError();
-        break;
-
-    case ObjectType::LIN_DLC_INFO:
-        obj = new LinDlcInfo();
-        break;
-
-    case ObjectType::LIN_RCV_ERROR:
-        obj = new LinReceiveError();
-        break;
-
-    case ObjectType::LIN_SND_ERROR:
-        obj = new LinSendError();
-        break;
-
-    case ObjectType::LIN_SLV_TIMEOUT:
-        obj = new LinSlaveTimeout();
-        break;
-
-    case ObjectType::LIN_SCHED_MODCH:
-        obj = new LinSchedulerModeChange();
-        break;
-
-    case ObjectType::LIN_SYN_ERROR:
-        obj = new LinSyncError();
-        break;
-
-    case ObjectType::LIN_BAUDRATE:
-        obj = new LinBaudrateEvent();
-        break;
-
-    case ObjectType::LIN_SLEEP:
-        obj = new LinSleepModeEvent();
-        break;
-
-    case ObjectType::LIN_WAKEUP:
-        obj = new LinWakeupEvent();
-        break;
-
-    case ObjectType::MOST_SPY:
-        obj = new MostSpy();
-        break;
-
-    case ObjectType::MOST_CTRL:
-        obj = new MostCtrl();
-        break;
-
-    case ObjectType::MOST_LIGHTLOCK:
-        obj = new MostLightLock();
-        break;
-
-    case ObjectType::MOST_STATISTIC:
-        obj = new MostStatistic();
-        break;
-
-    case ObjectType::Reserved26:
-    case ObjectType::Reserved27:
-    case ObjectType::Reserved28:
-        break;
-
-    case ObjectType::FLEXRAY_DATA:
-        obj = new FlexRayData();
-        break;
-
-    case ObjectType::FLEXRAY_SYNC:
-        obj = new FlexRaySync();
-        break;
-
-    case ObjectType::CAN_DRIVER_ERROR:
-        obj = new CanDriverError();
-        break;
-
-    case ObjectType::MOST_PKT:
-        obj = new MostPkt();
-        break;
-
-    case ObjectType::MOST_PKT2:
-        obj = new MostPkt2();
-        break;
-
-    case ObjectType::MOST_HWMODE:
-        obj = new MostHwMode();
-        break;
-
-    case ObjectType::MOST_REG:
-        obj = new MostReg();
-        break;
-
-    case ObjectType::MOST_GENREG:
-        obj = new MostGenReg();
-        break;
-
-    case ObjectType::MOST_NETSTATE:
-        obj = new MostNetState();
-        break;
-
-    case ObjectType::MOST_DATALOST:
-        obj = new MostDataLost();
-        break;
-
-    case ObjectType::MOST_TRIGGER:
-        obj = new MostTrigger();
-        break;
-
-    case ObjectType::FLEXRAY_CYCLE:
-        obj = new FlexRayV6StartCycleEvent();
-        break;
-
-    case ObjectType::FLEXRAY_MESSAGE:
-        obj = new FlexRayV6Message();
-        break;
-
-    case ObjectType::LIN_CHECKSUM_INFO:
-        obj = new LinChecksumInfo();
-        break;
-
-    case ObjectType::LIN_SPIKE_EVENT:
-        obj = new LinSpikeEvent();
-        break;
-        */
-
-    case ObjectType::CAN_DRIVER_SYNC:
-        obj = new CanDriverHwSync();
-        break;
-
-        /*
-    case ObjectType::FLEXRAY_STATUS:
-        obj = new FlexRayStatusEvent();
-        break;
-        */
-
-    case ObjectType::GPS_EVENT:
-        obj = new GpsEvent();
-        break;
-
-        /*
-    case ObjectType::FR_ERROR:
-        obj = new FlexRayVFrError();
-        break;
-
-    case ObjectType::FR_STATUS:
-        obj = new FlexRayVFrStatus();
-        break;
-
-    case ObjectType::FR_STARTCYCLE:
-        obj = new FlexRayVFrStartCycle();
-        break;
-
-    case ObjectType::FR_RCVMESSAGE:
-        obj = new FlexRayVFrReceiveMsg();
-        break;
-        */
-
-    case ObjectType::REALTIMECLOCK:
-        obj = new RealtimeClock();
-        break;
-
-    case ObjectType::Reserved52:
-    case ObjectType::Reserved53:
-        break;
-
-        /*
-    case ObjectType::LIN_STATISTIC:
-        obj = new LinStatisticEvent();
-        break;
-
-    case ObjectType::J1708_MESSAGE:
-    case ObjectType::J1708_VIRTUAL_MSG:
-        obj = new J1708Message();
-        break;
-
-    case ObjectType::LIN_MESSAGE2:
-        obj = new LinMessage2();
-        break;
-
-    case ObjectType::LIN_SND_ERROR2:
-        obj = new LinSendError2();
-        break;
-
-    case ObjectType::LIN_SYN_ERROR2:
-        obj = new LinSyncError2();
-        break;
-
-    case ObjectType::LIN_CRC_ERROR2:
-        obj = new LinCrcError2();
-        break;
-
-    case ObjectType::LIN_RCV_ERROR2:
-        obj = new LinReceiveError2();
-        break;
-
-    case ObjectType::LIN_WAKEUP2:
-        obj = new LinWakeupEvent2();
-        break;
-
-    case ObjectType::LIN_SPIKE_EVENT2:
-        obj = new LinSpikeEvent2();
-        break;
-
-    case ObjectType::LIN_LONG_DOM_SIG:
-        obj = new LinLongDomSignalEvent();
-        break;
-
-    case ObjectType::APP_TEXT:
-        obj = new AppText();
-        break;
-
-    case ObjectType::FR_RCVMESSAGE_EX:
-        obj = new FlexRayVFrReceiveMsgEx();
-        break;
-
-    case ObjectType::MOST_STATISTICEX:
-        obj = new MostStatisticEx();
-        break;
-
-    case ObjectType::MOST_TXLIGHT:
-        obj = new MostTxLight();
-        break;
-
-    case ObjectType::MOST_ALLOCTAB:
-        obj = new MostAllocTab();
-        break;
-
-    case ObjectType::MOST_STRESS:
-        obj = new MostStress();
-        break;
-
-    case ObjectType::ETHERNET_FRAME:
-        obj = new EthernetFrame();
-        break;
-
-    case ObjectType::SYS_VARIABLE:
-        obj = new SystemVariable();
-        break;
-        */
-
-    case ObjectType::CAN_ERROR_EXT:
-        obj = new CanErrorFrameExt();
-        break;
-
-    case ObjectType::CAN_DRIVER_ERROR_EXT:
-        obj = new CanDriverErrorExt();
-        break;
-
-        /*
-    case ObjectType::LIN_LONG_DOM_SIG2:
-        obj = new LinLongDomSignalEvent2();
-        break;
-
-    case ObjectType::MOST_150_MESSAGE:
-        obj = new Most150Message();
-        break;
-
-    case ObjectType::MOST_150_PKT:
-        obj = new Most150Pkt();
-        break;
-
-    case ObjectType::MOST_ETHERNET_PKT:
-        obj = new MostEthernetPkt();
-        break;
-
-    case ObjectType::MOST_150_MESSAGE_FRAGMENT:
-        obj = new Most150MessageFragment();
-        break;
-
-    case ObjectType::MOST_150_PKT_FRAGMENT:
-        obj = new Most150PktFragment();
-        break;
-
-    case ObjectType::MOST_ETHERNET_PKT_FRAGMENT:
-        obj = new MostEthernetPktFragment();
-        break;
-
-    case ObjectType::MOST_SYSTEM_EVENT:
-        obj = new MostSystemEvent();
-        break;
-
-    case ObjectType::MOST_150_ALLOCTAB:
-        obj = new Most150AllocTab();
-        break;
-
-    case ObjectType::MOST_50_MESSAGE:
-        obj = new Most50Message();
-        break;
-
-    case ObjectType::MOST_50_PKT:
-        obj = new Most50Pkt();
-        break;
-        */
-
-    case ObjectType::CAN_MESSAGE2:
-        obj = new CanMessage2();
-        break;
-        /*
-
-    case ObjectType::LIN_UNEXPECTED_WAKEUP:
-        obj = new LinUnexpectedWakeup();
-        break;
-
-    case ObjectType::LIN_SHORT_OR_SLOW_RESPONSE:
-        obj = new LinShortOrSlowResponse();
-        break;
-
-    case ObjectType::LIN_DISTURBANCE_EVENT:
-        obj = new LinDisturbanceEvent();
-        break;
-        */
-
-    case ObjectType::SERIAL_EVENT:
-        obj = new SerialEvent();
-        break;
-
-    case ObjectType::OVERRUN_ERROR:
-        obj = new DriverOverrun();
-        break;
-
-    case ObjectType::EVENT_COMMENT:
-        obj = new EventComment();
-        break;
-
-        /*
-    case ObjectType::WLAN_FRAME:
-        obj = new WlanFrame();
-        break;
+void File::cancel() {
+    /* only reading is cancelled */
+    if (!(m_openMode & std::ios_base::in))
+        return;
 
-    case ObjectType::WLAN_STATISTIC:
-        obj = new WlanStatistic();
-        break;
+    m_cancelled = true;
 
-    case ObjectType::MOST_ECL:
-        obj = new MostEcl();
-        break;
-        */
+    /* stop threads without draining */
+    m_compressedFileThreadRunning = false;
+    m_uncompressedFileThreadRunning = false;
+    m_uncompressedFile.abort();
+    m_readWriteQueue.abort();
+}
 
-    case ObjectType::GLOBAL_MARKER:
-        obj = new GlobalMarker();
-        break;
+bool File::cancelled() const {
+    return m_cancelled;
+}
 
-        /*
-    case ObjectType::AFDX_FRAME:
-        obj = new AfdxFrame();
-        break;
+void File::reportProgress(bool force) {
+    /* check */
+    if (!progressCallback)
+        return;
 
-    case ObjectType::AFDX_STATISTIC:
-        obj = new AfdxStatistic();
-        break;
+    /* limit rate */
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!force && (now - m_lastProgressCallback < progressInterval))
+        return;
+    m_lastProgressCallback = now;
 
-    case ObjectType::KLINE_STATUSEVENT:
-        obj = new KLineStatusEvent();
-        break;
-        */
+    progressCallback(progress());
+}
 
-    case ObjectType::CAN_FD_MESSAGE:
-        obj = new CanFdMessage();
-        break;
+uint32_t File::defaultLogContainerSize() const {
+    return m_uncompressedFile.defaultLogContainerSize();
+}
 
-    case ObjectType::CAN_FD_MESSAGE_64:
-        obj = new CanFdMessage64();
-        break;
+void File::setDefaultLogContainerSize(uint32_t defaultLogContainerSize) {
+    m_uncompressedFile.setDefaultLogContainerSize(defaultLogContainerSize);
+}
 
-        /*
-    case ObjectType::ETHERNET_RX_ERROR:
-        obj = new EthernetRxError();
-        break;
+std::chrono::milliseconds File::maxFlushLatency() const {
+    return std::chrono::milliseconds(m_maxFlushLatency.load());
+}
 
-    case ObjectType::ETHERNET_STATUS:
-        obj = new EthernetStatus();
-        break;
-        */
-    case ObjectType::CAN_FD_ERROR_64:
-        obj = new CanFdErrorFrame64();
-        break;
+void File::setMaxFlushLatency(std::chrono::milliseconds maxFlushLatency) {
+    m_maxFlushLatency = maxFlushLatency.count();
+}
 
-        /*
-    case ObjectType::LIN_SHORT_OR_SLOW_RESPONSE2:
-        obj = new LinShortOrSlowResponse2;
-        break;
+ObjectHeaderBase * File::createObject(ObjectType type) {
+    ObjectHeaderBase * obj = nullptr;
 
-    case ObjectType::AFDX_STATUS:
-        obj = new AfdxStatus;
+    switch (type) {
+#define VECTOR_BLF_CREATE_OBJECT(objectType, className) \
+    case ObjectType::objectType: \
+        obj = new className(); \
         break;
+    VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_CREATE_OBJECT)
+#undef VECTOR_BLF_CREATE_OBJECT
 
-    case ObjectType::AFDX_BUS_STATISTIC:
-        obj = new AfdxBusStatistic;
+    default:
+        /* unknown or reserved objectType */
         break;
+    }
 
-    case ObjectType::Reserved108:
-        break;
+    return obj;
+}
 
-    case ObjectType::AFDX_ERROR_EVENT:
-        obj = new AfdxErrorEvent;
-        break;
+/** maximum plausible size of a LogContainer */
+static const uint32_t maxPlausibleLogContainerSize = 0x4000000;
+
+/** maximum plausible size of an object, that might span several LogContainers */
+static const uint32_t maxPlausibleObjectSize = 0x4000000;
+
+/**
+ * Scan file for the next plausible object header after position.
+ *
+ * @param[in] file file
+ * @param[in] position position to start after
+ * @param[in] plausible predicate that checks the object header
+ * @param[out] result position of the found object header, or end of data
+ * @param[out] zeros true if all skipped bytes are zero
+ * @return true if a plausible object header was found
+ */
+template <typename T, typename Predicate>
+static bool findNextObjectHeader(T & file, std::streampos position, Predicate plausible, std::streampos & result, bool & zeros) {
+    const std::streamsize headerSize = ObjectHeaderBase(0, ObjectType::UNKNOWN).calculateHeaderSize();
+    std::vector<char> buffer(0x10000);
+    std::streampos scanPosition = position;
+    std::streamsize start = 1; // skip the object header at position
+    zeros = true;
+    for (;;) {
+        /* read next block */
+        file.clear();
+        file.seekg(scanPosition, std::ios_base::beg);
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize gcount = file.gcount();
+
+        /* search for signature */
+        for (std::streamsize i = start; i + headerSize <= gcount; i++) {
+            ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+            const char * p = buffer.data() + i;
+            std::memcpy(&ohb.signature, p, sizeof(ohb.signature));
+            if (ohb.signature != ObjectSignature)
+                continue;
+            p += sizeof(ohb.signature);
+            std::memcpy(&ohb.headerSize, p, sizeof(ohb.headerSize));
+            p += sizeof(ohb.headerSize);
+            std::memcpy(&ohb.headerVersion, p, sizeof(ohb.headerVersion));
+            p += sizeof(ohb.headerVersion);
+            std::memcpy(&ohb.objectSize, p, sizeof(ohb.objectSize));
+            p += sizeof(ohb.objectSize);
+            std::memcpy(&ohb.objectType, p, sizeof(ohb.objectType));
+            if (plausible(ohb)) {
+                zeros = zeros && std::all_of(buffer.data(), buffer.data() + i, [](char c) {
+                    return c == 0;
+                });
+                result = scanPosition + static_cast<std::streamoff>(i);
+                file.clear();
+                file.seekg(result, std::ios_base::beg);
+                return true;
+            }
+        }
 
-    case ObjectType::A429_ERROR:
-        obj = new A429Error;
-        break;
+        /* end of data */
+        zeros = zeros && std::all_of(buffer.data(), buffer.data() + gcount, [](char c) {
+            return c == 0;
+        });
+        if (gcount < static_cast<std::streamsize>(buffer.size())) {
+            result = scanPosition + static_cast<std::streamoff>(gcount);
+            return false;
+        }
 
-    case ObjectType::A429_STATUS:
-        obj = new A429Status;
-        break;
+        /* overlap blocks by a header */
+        scanPosition += gcount - headerSize + 1;
+        start = 0;
+    }
+}
 
-    case ObjectType::A429_BUS_STATISTIC:
-        obj = new A429BusStatistic;
-        break;
+std::vector<SkippedRange> File::skippedRanges() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_skippedRangesMutex);
 
-    case ObjectType::A429_MESSAGE:
-        obj = new A429Message;
-        break;
+    return m_skippedRanges;
+}
 
-    case ObjectType::ETHERNET_STATISTIC:
-        obj = new EthernetStatistic;
-        break;
-        */
+uint64_t File::resyncCount() const {
+    return m_resyncCount;
+}
 
-    case ObjectType::Unknown115:
-        obj = new RestorePointContainer;
-        break;
+bool File::plausibleObjectHeader(const ObjectHeaderBase & ohb) const {
+    /* header size is not checked exactly, as some objects use VarObjectHeader */
+    return
+        (ohb.signature == ObjectSignature) &&
+        ((ohb.headerVersion == 1) || (ohb.headerVersion == 2)) &&
+        (ohb.headerSize >= ohb.calculateHeaderSize()) &&
+        (ohb.objectSize >= ohb.headerSize) &&
+        (ohb.objectSize <= maxPlausibleObjectSize) &&
+        (ohb.objectType != ObjectType::UNKNOWN) &&
+        (ohb.objectType != ObjectType::LOG_CONTAINER) &&
+        (ohb.objectType <= ObjectType::ATTRIBUTE_EVENT);
+}
 
-    case ObjectType::Reserved116:
-    case ObjectType::Reserved117:
-        break;
+bool File::plausibleLogContainerHeader(const ObjectHeaderBase & ohb) {
+    return
+        (ohb.signature == ObjectSignature) &&
+        (ohb.headerSize == ohb.calculateHeaderSize()) &&
+        (ohb.headerVersion == 1) &&
+        (ohb.objectType == ObjectType::LOG_CONTAINER) &&
+        (ohb.objectSize >= LogContainer().internalHeaderSize()) &&
+        (ohb.objectSize <= maxPlausibleLogContainerSize);
+}
 
-    case ObjectType::TEST_STRUCTURE:
-        obj = new TestStructure;
-        break;
+void File::addSkippedRange(SkippedRange::Level level, uint64_t position, uint64_t size) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_skippedRangesMutex);
 
-    case ObjectType::DIAG_REQUEST_INTERPRETATION:
-        obj = new DiagRequestInterpretation;
-        break;
+    SkippedRange skippedRange;
+    skippedRange.level = level;
+    skippedRange.position = position;
+    skippedRange.size = size;
+    m_skippedRanges.push_back(skippedRange);
+}
 
-        /*
-    case ObjectType::ETHERNET_FRAME_EX:
-        obj = new EthernetFrameEx;
-        break;
+void File::resyncUncompressedFile(std::streampos position) {
+    std::streampos nextPosition;
+    bool zeros;
+    findNextObjectHeader(m_uncompressedFile, position, [this](const ObjectHeaderBase & ohb) {
+        return plausibleObjectHeader(ohb);
+    }, nextPosition, zeros);
+    if (nextPosition > position)
+        m_resyncCount++;
+
+    /* up to 3 bytes are padding, that is not covered by objectSize, and LogContainers might be filled up with zeros */
+    if ((nextPosition - position > 3) && !zeros)
+        addSkippedRange(SkippedRange::Uncompressed, static_cast<uint64_t>(position), static_cast<uint64_t>(nextPosition - position));
+}
 
-    case ObjectType::ETHERNET_FRAME_FORWARDED:
-        obj = new EthernetFrameForwarded;
-        break;
+void File::resyncCompressedFile(std::streampos position) {
+    std::streampos nextPosition;
+    bool zeros;
+    findNextObjectHeader(m_compressedFile, position, [](const ObjectHeaderBase & ohb) {
+        return plausibleLogContainerHeader(ohb);
+    }, nextPosition, zeros);
+    if (nextPosition > position) {
+        m_resyncCount++;
+        addSkippedRange(SkippedRange::Compressed, static_cast<uint64_t>(position), static_cast<uint64_t>(nextPosition - position));
+
+        /* objects spanning the gap in uncompressedFile are corrupted */
+        std::lock_guard<std::mutex> lock(m_skippedRangesMutex);
+        m_discontinuities.push_back(m_uncompressedFile.tellp());
+    }
+}
 
-    case ObjectType::ETHERNET_ERROR_EX:
-        obj = new EthernetErrorEx;
-        break;
+bool File::nextDiscontinuity(std::streampos begin, std::streampos end, std::streampos & discontinuity) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_skippedRangesMutex);
 
-    case ObjectType::ETHERNET_ERROR_FORWARDED:
-        obj = new EthernetErrorForwarded;
-        break;
-        */
+    /* discard gaps before begin */
+    while (!m_discontinuities.empty() && (m_discontinuities.front() <= begin))
+        m_discontinuities.pop_front();
 
-    case ObjectType::FUNCTION_BUS:
-        obj = new FunctionBus;
-        break;
+    if (m_discontinuities.empty() || (m_discontinuities.front() >= end))
+        return false;
+    discontinuity = m_discontinuities.front();
+    return true;
+}
 
-    case ObjectType::DATA_LOST_BEGIN:
-        obj = new DataLostBegin;
-        break;
+void File::recoverObject(const ObjectHeaderBase & ohb, std::streampos position) {
+    /* check object header */
+    bool plausible = plausibleObjectHeader(ohb);
+
+    /* copy object into a separate buffer */
+    std::vector<char> data;
+    if (plausible) {
+        enlargeUncompressedFile(ohb.objectSize);
+        data.resize(ohb.objectSize);
+        m_uncompressedFile.seekg(position, std::ios_base::beg);
+        m_uncompressedFile.read(data.data(), ohb.objectSize);
+        m_uncompressedFile.seekg(ohb.objectSize % 4, std::ios_base::cur);
+    }
 
-    case ObjectType::DATA_LOST_END:
-        obj = new DataLostEnd;
-        break;
+    /* continue after a gap, left by a skipped LogContainer */
+    std::streampos end = position + static_cast<std::streamoff>(plausible ? ohb.objectSize : ohb.calculateHeaderSize());
+    std::streampos discontinuity;
+    if (nextDiscontinuity(position, end, discontinuity)) {
+        addSkippedRange(SkippedRange::Uncompressed, static_cast<uint64_t>(position), static_cast<uint64_t>(discontinuity - position));
+        m_uncompressedFile.clear();
+        m_uncompressedFile.seekg(discontinuity, std::ios_base::beg);
+        return;
+    }
 
-    case ObjectType::WATER_MARK_EVENT:
-        obj = new WaterMarkEvent;
-        break;
+    /* scan for next object */
+    if (!plausible) {
+        resyncUncompressedFile(position);
+        return;
+    }
 
-    case ObjectType::TRIGGER_CONDITION:
-        obj = new TriggerCondition;
-        break;
+    /* object is truncated at end of file */
+    if (!m_uncompressedFile.good()) {
+        addSkippedRange(SkippedRange::Uncompressed, static_cast<uint64_t>(position), static_cast<uint64_t>(m_uncompressedFile.gcount()));
+        return;
+    }
 
-    case ObjectType::CAN_SETTING_CHANGED:
-        obj = new CanSettingChanged;
-        break;
+    /* create object */
+    ObjectHeaderBase * obj = createObject(ohb.objectType);
+    if (obj == nullptr) {
+        /* in case of unknown objectType */
+        m_uncompressedFile.dropOldData();
+        return;
+    }
 
-    case ObjectType::DISTRIBUTED_OBJECT_MEMBER:
-        obj = new DistributedObjectMember;
-        break;
+    /* read object */
+    UncompressedFile objectFile;
+    objectFile.setDefaultLogContainerSize(ohb.objectSize);
+    objectFile.write(data.data(), ohb.objectSize);
+    objectFile.setFileSize(ohb.objectSize);
+    try {
+        obj->read(objectFile);
+    } catch (std::exception &) {
+        /* corrupted content */
+        delete obj;
+        addSkippedRange(SkippedRange::Uncompressed, static_cast<uint64_t>(position), ohb.objectSize);
+        m_uncompressedFile.dropOldData();
+        return;
+    }
 
-    case ObjectType::ATTRIBUTE_EVENT:
-        obj = new AttributeEvent;
-        break;
+    /* statistics, before the object is passed on */
+    if (obj->objectType != ObjectType::Unknown115) {
+        currentObjectCount++;
+        m_readObjectTimeStamp = objectTimeStampNs(*obj);
     }
 
-    return obj;
+    /* push data into readWriteQueue */
+    m_readWriteQueue.write(obj);
+
+    /* drop old data */
+    m_uncompressedFile.dropOldData();
 }
 
 void File::uncompressedFile2ReadWriteQueue() {
+    /* remember position for recovery */
+    std::streampos position = m_uncompressedFile.tellg();
+
     /* identify type */
     ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
-    ohb.read(m_uncompressedFile);
+    try {
+        ohb.read(m_uncompressedFile);
+    } catch (Vector::BLF::Exception &) {
+        /* signature mismatch */
+        if (!recoverCorruption)
+            throw;
+        resyncUncompressedFile(position);
+        return;
+    }
     if (!m_uncompressedFile.good()) {
         /* This is a normal eof. No objects ended abruptly. */
         return;
     }
+
+    /* recovery mode */
+    if (recoverCorruption) {
+        recoverObject(ohb, position);
+        return;
+    }
     m_uncompressedFile.seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
 
+#ifdef VECTOR_BLF_USE_METRICS
+    std::chrono::steady_clock::time_point decodeStart = std::chrono::steady_clock::now();
+#endif
+
     /* create object */
     ObjectHeaderBase * obj = createObject(ohb.objectType);
     if (obj == nullptr) {
@@ -744,6 +786,7 @@ void File::uncompressedFile2ReadWriteQueue() {
     }
 
     /* read object */
+    enlargeUncompressedFile(ohb.objectSize);
     obj->read(m_uncompressedFile);
     if (!m_uncompressedFile.good()) {
         delete obj;
@@ -754,97 +797,370 @@ void File::uncompressedFile2ReadWriteQueue() {
         m_uncompressedFile.seekg(tmp);
     }
 
-    /* push data into readWriteQueue */
-    m_readWriteQueue.write(obj);
+#ifdef VECTOR_BLF_USE_METRICS
+    /* metrics */
+    if (static_cast<std::size_t>(ohb.objectType) < decodeCounterCount)
+        m_decodeCounters[static_cast<std::size_t>(ohb.objectType)].add(ohb.objectSize, std::chrono::steady_clock::now() - decodeStart);
+#endif
 
-    /* statistics */
-    if (obj->objectType != ObjectType::Unknown115)
+    /* statistics, before the object is passed on */
+    if (obj->objectType != ObjectType::Unknown115) {
         currentObjectCount++;
+        m_readObjectTimeStamp = objectTimeStampNs(*obj);
+    }
+
+    /* push data into readWriteQueue */
+    m_readWriteQueue.write(obj);
 
     /* drop old data */
     m_uncompressedFile.dropOldData();
 }
 
 void File::readWriteQueue2UncompressedFile() {
+    /* seal log container, when the flush latency is exceeded */
+    std::chrono::milliseconds maxFlushLatency = this->maxFlushLatency();
+    bool flushPending = (maxFlushLatency.count() > 0) && !m_logContainerWriter.empty();
+    if (flushPending && (std::chrono::steady_clock::now() >= m_unflushedSince + maxFlushLatency)) {
+        m_logContainerWriter.seal();
+        flushPending = false;
+    }
+
     /* get from readWriteQueue */
-    ObjectHeaderBase * ohb = m_readWriteQueue.read();
+    ObjectHeaderBase * ohb = flushPending ?
+        m_readWriteQueue.read(m_unflushedSince + maxFlushLatency) :
+        m_readWriteQueue.read();
 
     /* process data */
     if (ohb == nullptr) {
-        // Read intentionally returns, when the thread is aborted.
+        // Read intentionally returns, when the thread is aborted or the flush latency is reached.
         return;
     }
 
-    /* write into uncompressedFile */
-    ohb->write(m_uncompressedFile);
+    /* remember restore point before the object, as it may complete a log container */
+    if (writeRestorePoints &&
+            (ohb->objectType != ObjectType::Unknown115) &&
+            (currentObjectCount % (static_cast<uint64_t>(restorePointInterval) + 1) == restorePointInterval)) {
+        RestorePoint restorePoint;
+        restorePoint.timeStamp = objectTimeStampNs(*ohb);
+        restorePoint.compressedFilePosition = static_cast<uint64_t>(m_logContainerWriter.tellp());
+        std::lock_guard<std::mutex> lock(m_restorePointsMutex);
+        m_pendingRestorePoints.push_back(restorePoint);
+    }
+
+    /* serialize into log container */
+    if (m_logContainerWriter.empty())
+        m_unflushedSince = std::chrono::steady_clock::now();
+    ohb->write(m_logContainerWriter);
+
+    /* remember object end for checkpoints */
+    if (checkpointsEnabled()) {
+        std::lock_guard<std::mutex> lock(m_objectEndPositionsMutex);
+        m_objectEndPositions.push_back(m_logContainerWriter.tellp());
+    }
 
     /* statistics */
-    if (ohb->objectType != ObjectType::Unknown115)
+    if (ohb->objectType != ObjectType::Unknown115) {
         currentObjectCount++;
+        uint64_t objectTimeStamp = objectTimeStampNs(*ohb);
+        if (objectTimeStamp > m_lastObjectTimeStamp)
+            m_lastObjectTimeStamp = objectTimeStamp;
+    }
 
     /* delete object */
     delete ohb;
 }
 
 void File::compressedFile2UncompressedFile() {
-    /* read header to identify type */
-    ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
-    ohb.read(m_compressedFile);
-    if (!m_compressedFile.good())
-        throw Exception("File::compressedFile2UncompressedFile(): Read beyond end of file.");
-    m_compressedFile.seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
-    if (ohb.objectType != ObjectType::LOG_CONTAINER)
-        throw Exception("File::compressedFile2UncompressedFile(): Object read for inflation is not a log container.");
-
-    /* read LogContainer */
+    /* remember position for recovery */
+    std::streampos position = m_compressedFile.tellg();
+
     std::shared_ptr<LogContainer> logContainer(new LogContainer);
-    logContainer->read(m_compressedFile);
-    if (!m_compressedFile.good())
-        throw Exception("File::compressedFile2UncompressedFile(): Read beyond end of file.");
+    try {
+        /* read header to identify type */
+        ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+        ohb.read(m_compressedFile);
+        if (!m_compressedFile.good())
+            throw Exception("File::compressedFile2UncompressedFile(): Read beyond end of file.");
+        m_compressedFile.seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
+        if (ohb.objectType != ObjectType::LOG_CONTAINER)
+            throw Exception("File::compressedFile2UncompressedFile(): Object read for inflation is not a log container.");
+        if (recoverCorruption && !plausibleLogContainerHeader(ohb))
+            throw Exception("File::compressedFile2UncompressedFile(): Implausible log container header.");
+
+        /* take LogContainer from cache */
+        std::shared_ptr<const LogContainer> cachedLogContainer;
+        if (logContainerCache)
+            cachedLogContainer = logContainerCache->get(m_fileIdentity, static_cast<uint64_t>(position), ohb.objectSize);
+        if (cachedLogContainer) {
+            m_compressedFile.seekg(ohb.objectSize + ohb.objectSize % 4, std::ios_base::cur);
+            *logContainer = *cachedLogContainer;
+        } else {
+            /* read LogContainer */
+            logContainer->read(m_compressedFile);
+            if (!m_compressedFile.good())
+                throw Exception("File::compressedFile2UncompressedFile(): Read beyond end of file.");
+
+            /* uncompress */
+#ifdef VECTOR_BLF_USE_METRICS
+            std::chrono::steady_clock::time_point inflateStart = std::chrono::steady_clock::now();
+            logContainer->uncompress();
+            m_inflateCounters.add(logContainer->uncompressedFileSize, std::chrono::steady_clock::now() - inflateStart);
+#else
+            logContainer->uncompress();
+#endif
+            if (logContainerCache)
+                logContainerCache->put(m_fileIdentity, static_cast<uint64_t>(position), *logContainer);
+        }
+    } catch (Vector::BLF::Exception &) {
+        /* wait until an incomplete LogContainer at the end of file is completely written */
+        if (follow && !m_compressedFile.good()) {
+            m_compressedFile.clear();
+            m_compressedFile.seekg(position, std::ios_base::beg);
+            m_compressedFile.discardReadAhead();
+            std::this_thread::sleep_for(followPollInterval);
+            return;
+        }
+
+        if (!recoverCorruption)
+            throw;
+        resyncCompressedFile(position);
+        return;
+    }
 
     /* statistics */
     currentUncompressedFileSize +=
         logContainer->internalHeaderSize() +
         logContainer->uncompressedFileSize;
 
-    /* uncompress */
-    logContainer->uncompress();
+    /* progress */
+    m_compressedBytesRead = static_cast<uint64_t>(m_compressedFile.tellg());
+    m_logContainersRead++;
 
     /* copy into uncompressedFile */
     m_uncompressedFile.write(logContainer);
+
+    /* progress */
+    reportProgress(false);
 }
 
 void File::uncompressedFile2CompressedFile() {
-    /* setup new log container */
-    LogContainer logContainer;
+    /* get LogContainer, usually without copying the data */
+    std::shared_ptr<LogContainer> logContainer = m_uncompressedFile.readLogContainer();
 
-    /* copy data into LogContainer */
-    logContainer.uncompressedFile.resize(m_uncompressedFile.defaultLogContainerSize());
-    m_uncompressedFile.read(
-        reinterpret_cast<char *>(logContainer.uncompressedFile.data()),
-        m_uncompressedFile.defaultLogContainerSize());
-    logContainer.uncompressedFileSize = static_cast<uint32_t>(m_uncompressedFile.gcount());
-    logContainer.uncompressedFile.resize(logContainer.uncompressedFileSize);
+    /* nothing left at end of file */
+    if (logContainer->uncompressedFileSize == 0)
+        return;
 
     /* compress */
     if (compressionLevel == 0) {
         /* no compression */
-        logContainer.compress(0, 0);
+        logContainer->compress(0, 0);
     } else {
         /* zlib compression */
-        logContainer.compress(2, compressionLevel);
+        logContainer->compress(2, compressionLevel);
     }
 
     /* write log container */
-    logContainer.write(m_compressedFile);
+    std::streampos position = m_compressedFile.tellp();
+    logContainer->write(m_compressedFile);
+    currentCompressedFileSize = static_cast<uint64_t>(m_compressedFile.tellp());
+    if (m_maxFlushLatency > 0)
+        m_compressedFile.flush();
+    {
+        std::lock_guard<std::mutex> lock(m_compressedObjectsMutex);
+        m_compressedObjectsSize += logContainer->uncompressedFileSize;
+    }
+    m_compressedObjectsChanged.notify_all();
+
+    /* restore points of the objects starting in this log container */
+    uint64_t begin = static_cast<uint64_t>(m_checkpointUncompressedPosition);
+    uint64_t end = begin + logContainer->uncompressedFileSize;
+    {
+        std::lock_guard<std::mutex> lock(m_restorePointsMutex);
+        while (!m_pendingRestorePoints.empty() && (m_pendingRestorePoints.front().compressedFilePosition < end)) {
+            RestorePoint restorePoint = m_pendingRestorePoints.front();
+            m_pendingRestorePoints.pop_front();
+            restorePoint.uncompressedFileOffset = static_cast<uint32_t>(restorePoint.compressedFilePosition - begin);
+            restorePoint.compressedFilePosition = static_cast<uint64_t>(position);
+            m_restorePoints.restorePoints.push_back(restorePoint);
+        }
+    }
+    m_checkpointUncompressedPosition += logContainer->uncompressedFileSize;
 
     /* statistics */
     currentUncompressedFileSize +=
-        logContainer.internalHeaderSize() +
-        logContainer.uncompressedFileSize;
+        logContainer->internalHeaderSize() +
+        logContainer->uncompressedFileSize;
 
     /* drop old data */
     m_uncompressedFile.dropOldData();
+
+    /* checkpoint */
+    if (checkpointsEnabled())
+        checkpoint();
+}
+
+bool File::checkpointsEnabled() const {
+    return (checkpointInterval.count() > 0) || (checkpointSize > 0);
+}
+
+void File::setLastObjectTime() {
+    /* without measurement start time or objects, there is no last object time */
+    if ((fileStatistics.measurementStartTime.year == 0) || (fileStatistics.objectCount == 0))
+        return;
+
+    fileStatistics.lastObjectTime = nsToSystemTime(
+        systemTimeToNs(fileStatistics.measurementStartTime) +
+        static_cast<int64_t>(m_lastObjectTimeStamp.load()));
+}
+
+void File::writeRestorePointContainers() {
+    /* serialize restore points */
+    m_restorePoints.objectInterval = restorePointInterval;
+    UncompressedFile restorePointsData;
+    m_restorePoints.write(restorePointsData);
+    restorePointsData.setFileSize(restorePointsData.tellp());
+
+    /* all data stays in uncompressedFile, as there is no compressedFileThread anymore */
+    std::streamsize bufferSize = m_uncompressedFile.defaultLogContainerSize();
+    m_uncompressedFile.setBufferSize(std::numeric_limits<std::streamsize>::max());
+
+    /* split into restore point containers of up to 2000 bytes */
+    for (;;) {
+        RestorePointContainer restorePointContainer;
+        restorePointContainer.data.resize(2000);
+        restorePointsData.read(reinterpret_cast<char *>(restorePointContainer.data.data()), static_cast<std::streamsize>(restorePointContainer.data.size()));
+        if (restorePointsData.gcount() <= 0)
+            break;
+        restorePointContainer.data.resize(static_cast<std::size_t>(restorePointsData.gcount()));
+        restorePointContainer.write(m_logContainerWriter);
+    }
+    m_logContainerWriter.seal();
+
+    /* compress */
+    for (;;) {
+        m_uncompressedFile.clear();
+        if (m_uncompressedFile.tellg() >= m_uncompressedFile.tellp())
+            break;
+        uncompressedFile2CompressedFile();
+    }
+    m_uncompressedFile.setBufferSize(bufferSize);
+}
+
+bool File::readRestorePointContainers(std::streampos position) {
+    /* get end of file */
+    m_compressedFile.seekg(0, std::ios_base::end);
+    std::streampos endOfFile = m_compressedFile.tellg();
+    std::streampos endOfObjects = position;
+
+    /* uncompress the LogContainers till the end of file */
+    UncompressedFile restorePointContainers;
+    restorePointContainers.setBufferSize(std::numeric_limits<std::streamsize>::max());
+    UncompressedFile restorePointsData;
+    restorePointsData.setBufferSize(std::numeric_limits<std::streamsize>::max());
+    try {
+        while (position < endOfFile) {
+            std::shared_ptr<LogContainer> logContainer(new LogContainer);
+            m_compressedFile.seekg(position, std::ios_base::beg);
+            logContainer->readHeader(m_compressedFile);
+            if (!m_compressedFile.good() ||
+                    (logContainer->objectType != ObjectType::LOG_CONTAINER) ||
+                    (logContainer->objectSize < logContainer->internalHeaderSize()) ||
+                    (position + static_cast<std::streamoff>(logContainer->objectSize) > endOfFile))
+                break;
+            m_compressedFile.seekg(position, std::ios_base::beg);
+            logContainer->read(m_compressedFile);
+            logContainer->uncompress();
+            restorePointContainers.write(logContainer);
+            position += static_cast<std::streamoff>(logContainer->objectSize + logContainer->objectSize % 4);
+        }
+        restorePointContainers.setFileSize(restorePointContainers.tellp());
+
+        /* collect restore point data */
+        for (;;) {
+            ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+            ohb.read(restorePointContainers);
+            if (!restorePointContainers.good())
+                break;
+            if (ohb.objectType != ObjectType::Unknown115)
+                throw Exception("File::readRestorePointContainers(): Object is not a restore point container.");
+            restorePointContainers.seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
+            RestorePointContainer restorePointContainer;
+            restorePointContainer.read(restorePointContainers);
+            if (!restorePointContainers.good())
+                throw Exception("File::readRestorePointContainers(): Read beyond end of file.");
+            restorePointsData.write(reinterpret_cast<char *>(restorePointContainer.data.data()), restorePointContainer.dataLength);
+        }
+    } catch (Vector::BLF::Exception &) {
+        m_compressedFile.clear();
+        return false;
+    }
+    m_compressedFile.clear();
+    restorePointsData.setFileSize(restorePointsData.tellp());
+
+    /* read list header */
+    RestorePoints restorePoints;
+    restorePointsData.read(reinterpret_cast<char *>(&restorePoints.objectSize), sizeof(restorePoints.objectSize));
+    restorePointsData.read(reinterpret_cast<char *>(&restorePoints.objectInterval), sizeof(restorePoints.objectInterval));
+    if (!restorePointsData.good())
+        return false;
+
+    /* objectSize can be larger than the data, so only complete restore points are taken */
+    std::streamsize count = (restorePointsData.fileSize() - restorePointsData.tellg()) / RestorePoint::calculateObjectSize();
+    for (std::streamsize i = 0; i < count; ++i) {
+        RestorePoint restorePoint;
+        restorePoint.read(restorePointsData);
+        if (restorePoint.compressedFilePosition < static_cast<uint64_t>(endOfObjects))
+            restorePoints.restorePoints.push_back(restorePoint);
+    }
+    m_restorePoints = restorePoints;
+    return true;
+}
+
+void File::enlargeReadQueue(std::size_t bufferSize) {
+    if (bufferSize > 10)
+        m_readWriteQueue.setBufferSize(static_cast<uint32_t>(std::min<std::size_t>(bufferSize, std::numeric_limits<uint32_t>::max())));
+}
+
+void File::enlargeUncompressedFile(uint32_t objectSize) {
+    if (objectSize > m_uncompressedFile.bufferSize())
+        m_uncompressedFile.setBufferSize(objectSize);
+}
+
+void File::checkpoint() {
+    /* count objects that are completely written */
+    {
+        std::lock_guard<std::mutex> lock(m_objectEndPositionsMutex);
+        while (!m_objectEndPositions.empty() && (m_objectEndPositions.front() <= m_checkpointUncompressedPosition)) {
+            m_objectEndPositions.pop_front();
+            m_checkpointObjectCount++;
+        }
+    }
+
+    /* check if checkpoint is due */
+    std::streampos position = m_compressedFile.tellp();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    bool due =
+        ((checkpointSize > 0) && (static_cast<uint64_t>(position - m_lastCheckpointPosition) >= checkpointSize)) ||
+        ((checkpointInterval.count() > 0) && (now - m_lastCheckpointTime >= checkpointInterval));
+    if (!due)
+        return;
+
+    /* set file statistics */
+    fileStatistics.fileSize = static_cast<uint64_t>(position);
+    fileStatistics.uncompressedFileSize = currentUncompressedFileSize;
+    fileStatistics.objectCount = m_checkpointObjectCount;
+    setLastObjectTime();
+
+    /* update fileStatistics in place and sync to disk */
+    m_compressedFile.seekp(0);
+    fileStatistics.write(m_compressedFile);
+    m_compressedFile.seekp(position);
+    m_compressedFile.sync();
+
+    /* remember checkpoint */
+    m_lastCheckpointTime = now;
+    m_lastCheckpointPosition = position;
 }
 
 void File::uncompressedFileReadThread(File * file) {
@@ -880,6 +1196,9 @@ void File::uncompressedFileWriteThread(File * file) {
                 file->m_uncompressedFileThreadRunning = false;
         }
 
+        /* hand over the last log container */
+        file->m_logContainerWriter.seal();
+
         /* set end of file */
         file->m_uncompressedFile.setFileSize(file->m_uncompressedFile.tellp());
     } catch (...) {
@@ -904,6 +1223,9 @@ void File::compressedFileReadThread(File * file) {
 
         /* set end of file */
         file->m_uncompressedFile.setFileSize(file->m_uncompressedFile.tellp());
+
+        /* final progress */
+        file->reportProgress(true);
     } catch (...) {
         file->m_compressedFileThreadException = std::current_exception();
     }
@@ -925,6 +1247,13 @@ void File::compressedFileWriteThread(File * file) {
     } catch (...) {
         file->m_compressedFileThreadException = std::current_exception();
     }
+
+    /* wake up waitForCompressedObjects */
+    {
+        std::lock_guard<std::mutex> lock(file->m_compressedObjectsMutex);
+        file->m_compressedFileThreadRunning = false;
+    }
+    file->m_compressedObjectsChanged.notify_all();
 }
 
 }
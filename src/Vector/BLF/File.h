@@ -7,13 +7,26 @@
 #include "platform.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
+#include "CancellationToken.h"
 #include "CompressedFile.h"
 #include "FileStatistics.h"
+#include "LogContainerCache.h"
+#include "LogContainerWriter.h"
+#include "Metrics.h"
+#include "ObjectDispatch.h"
 #include "ObjectHeaderBase.h"
 #include "ObjectQueue.h"
+#include "ObjectRange.h"
 #include "RestorePoints.h"
 #include "UncompressedFile.h"
 
@@ -65,6 +78,49 @@
 namespace Vector {
 namespace BLF {
 
+/**
+ * Byte range that was skipped while reading in recovery mode.
+ */
+struct VECTOR_BLF_EXPORT SkippedRange {
+    /** level on which data was skipped */
+    enum Level : uint8_t {
+        /** compressed file, i.e. LogContainers */
+        Compressed,
+
+        /** uncompressed file, i.e. objects within LogContainers */
+        Uncompressed
+    };
+
+    /** level */
+    Level level {Compressed};
+
+    /** start position on this level */
+    uint64_t position {};
+
+    /** number of skipped bytes */
+    uint64_t size {};
+};
+
+/**
+ * Progress of reading a file.
+ */
+struct VECTOR_BLF_EXPORT Progress {
+    /** compressed bytes read, including the file statistics */
+    uint64_t compressedBytesRead {};
+
+    /** compressed file size from the file statistics */
+    uint64_t compressedFileSize {};
+
+    /** number of LogContainers read */
+    uint64_t logContainersRead {};
+
+    /** number of objects read, Unknown115 is not counted */
+    uint32_t objectsRead {};
+
+    /** timestamp in nanoseconds of the object read last */
+    uint64_t objectTimeStamp {};
+};
+
 /**
  * File
  *
@@ -94,6 +150,14 @@ class VECTOR_BLF_EXPORT File final {
      */
     std::atomic<uint32_t> currentObjectCount {};
 
+    /**
+     * Current compressed file size during write
+     *
+     * This is the end of the last LogContainer written to disk. Objects
+     * still queued for compression are not included.
+     */
+    std::atomic<uint64_t> currentCompressedFileSize {};
+
     /**
      * compression level
      *
@@ -111,22 +175,198 @@ class VECTOR_BLF_EXPORT File final {
 
     /**
      * Write restore points at file close.
+     *
+     * A RestorePoint is recorded for every restorePointInterval + 1st
+     * object, starting with object restorePointInterval. At close they are
+     * written as RestorePointContainers into a new LogContainer at
+     * fileStatistics.restorePointsOffset.
      */
     bool writeRestorePoints {true};
 
+    /**
+     * Restore point interval.
+     *
+     * @see RestorePoints::objectInterval
+     */
+    uint32_t restorePointInterval {1000};
+
+    /**
+     * Checkpoint interval in time.
+     *
+     * During write, the file statistics in the file header are updated
+     * and synced to disk, after a LogContainer was written and this time
+     * has elapsed since the last checkpoint.
+     * So after a power loss, only the data since the last checkpoint
+     * needs to be recovered.
+     *
+     * Zero disables time based checkpoints.
+     */
+    std::chrono::milliseconds checkpointInterval {0};
+
+    /**
+     * Checkpoint interval in (compressed) bytes.
+     *
+     * Same as checkpointInterval, but the file statistics are updated,
+     * if this amount of data was written since the last checkpoint.
+     *
+     * Zero disables size based checkpoints.
+     */
+    uint64_t checkpointSize {0};
+
+    /**
+     * Recover from corrupted data during read.
+     *
+     * By default reading stops at the first LogContainer or object with
+     * an invalid header. In recovery mode the file is scanned forward for
+     * the next plausible ObjectSignature instead, on both the compressed
+     * and uncompressed level, and reading continues from there.
+     * The skipped data is reported in skippedRanges().
+     */
+    bool recoverCorruption {false};
+
+    /**
+     * Follow a file, that is still being written, like tail -f.
+     *
+     * At the end of the file, reading waits for further LogContainers
+     * instead of setting eof. An incomplete LogContainer at the end of the
+     * file is read again after followPollInterval. The fileStatistics are
+     * read at open and might be outdated, so they are not used to detect
+     * the end of the file. Reading only ends at close.
+     *
+     * Set before open.
+     */
+    bool follow {false};
+
+    /**
+     * Interval, in which the end of a followed file is checked for new
+     * LogContainers.
+     */
+    std::chrono::milliseconds followPollInterval {100};
+
+    /**
+     * Cache of uncompressed LogContainers.
+     *
+     * LogContainers found in the cache are not uncompressed again, and
+     * uncompressed ones are put into it. Use LogContainerCache::forPath to
+     * share it with other Files opened on the same path.
+     *
+     * Set before open.
+     */
+    std::shared_ptr<LogContainerCache> logContainerCache {};
+
+    /**
+     * Function, that is called with the progress during read.
+     *
+     * It's called by the thread reading the compressed file, after a
+     * LogContainer was read and progressInterval has elapsed, and once at
+     * the end of the file. It should return quickly.
+     *
+     * Set before open.
+     */
+    std::function<void(const Progress &)> progressCallback {};
+
+    /**
+     * Minimum time between two calls of progressCallback.
+     */
+    std::chrono::milliseconds progressInterval {100};
+
+    /**
+     * Token to cancel reading.
+     *
+     * @see cancel
+     *
+     * Set before open.
+     */
+    std::shared_ptr<CancellationToken> cancellationToken {};
+
+    /**
+     * Get the progress of reading.
+     *
+     * This is a snapshot of counters, that are updated by the File threads.
+     * It can be called from any thread.
+     *
+     * @return progress
+     */
+    virtual Progress progress() const;
+
+    /**
+     * Cancel reading.
+     *
+     * The File threads are stopped without reading the remaining data, and
+     * objects still queued are not passed on. Readers waiting in read get
+     * eof. Call close afterwards, as usual.
+     *
+     * This can be called from any thread, also from progressCallback.
+     * It has no effect on files opened for writing.
+     */
+    virtual void cancel();
+
+    /**
+     * Was reading cancelled?
+     *
+     * @return true if cancelled
+     */
+    virtual bool cancelled() const;
+
+    /**
+     * Get counters and timers of the pipeline stages.
+     *
+     * They show, whether disk I/O, inflate, object decoding or the
+     * consumer is the bottleneck. They are only collected, if the library
+     * is built with OPTION_USE_METRICS, otherwise Metrics::enabled is false.
+     * It can be called from any thread.
+     *
+     * @return metrics
+     */
+    virtual Metrics metrics() const;
+
+    /**
+     * Byte ranges skipped in recovery mode.
+     *
+     * @return skipped byte ranges
+     */
+    virtual std::vector<SkippedRange> skippedRanges() const;
+
+    /**
+     * Number of scans over data to the next plausible header in recovery
+     * mode.
+     *
+     * This includes scans over a few bytes, that are not reported as
+     * skipped ranges. A clean file is read without any.
+     *
+     * @return number of resynchronizations
+     */
+    virtual uint64_t resyncCount() const;
+
     /**
      * open file
      *
+     * In append mode (app), an existing file is continued after its last
+     * complete LogContainer. The existing objects are not rewritten. Its
+     * restore points are overwritten and written again at close, together
+     * with the new ones. restorePointInterval is taken from the file then.
+     * A file, that doesn't exist or is empty, is started as new one. An
+     * existing file, that is no BLF file, is left untouched and an
+     * Exception is thrown.
+     *
      * @param[in] filename file name
-     * @param[in] mode open mode, either in (read) or out (write)
+     * @param[in] mode open mode, either in (read), out (write) or app (append)
      */
     virtual void open(const char * filename, const std::ios_base::openmode mode = std::ios_base::in);
 
     /**
      * open file
      *
+     * In append mode (app), an existing file is continued after its last
+     * complete LogContainer. The existing objects are not rewritten. Its
+     * restore points are overwritten and written again at close, together
+     * with the new ones. restorePointInterval is taken from the file then.
+     * A file, that doesn't exist or is empty, is started as new one. An
+     * existing file, that is no BLF file, is left untouched and an
+     * Exception is thrown.
+     *
      * @param[in] filename file name
-     * @param[in] mode open mode, either in (read) or out (write)
+     * @param[in] mode open mode, either in (read), out (write) or app (append)
      */
     virtual void open(const std::string & filename, const std::ios_base::openmode mode = std::ios_base::in);
 
@@ -163,6 +403,89 @@ class VECTOR_BLF_EXPORT File final {
      */
     virtual ObjectHeaderBase * read();
 
+    /**
+     * Read object from file, waiting at most timeout.
+     *
+     * This is useful with follow, where read() waits until further objects
+     * are written into the file. On timeout the state stays good.
+     *
+     * Ownership is taken over from the library to the user.
+     * The user has to take care to delete the object.
+     *
+     * @param[in] timeout maximum time to wait for an object
+     * @return read object or nullptr
+     */
+    virtual ObjectHeaderBase * read(std::chrono::milliseconds timeout);
+
+    /**
+     * Read several objects from file.
+     *
+     * Waits until an object is available, and then takes all available
+     * objects, up to count, at once.
+     *
+     * Ownership is taken over from the library to the user.
+     * The user has to take care to delete the objects.
+     *
+     * @param[out] objects read objects
+     * @param[in] count maximum number of objects
+     * @return number of read objects (or 0 at eof)
+     */
+    virtual std::size_t read(ObjectHeaderBase ** objects, std::size_t count);
+
+    /**
+     * Read several objects from file, without waiting.
+     *
+     * Takes the objects, that are available, up to count. Together with
+     * callWhenReadable, this allows to read from an event loop.
+     *
+     * @param[out] objects read objects
+     * @param[in] count maximum number of objects
+     * @return number of read objects. If it's 0, eof() tells if the end is
+     *   reached.
+     */
+    virtual std::size_t tryRead(ObjectHeaderBase ** objects, std::size_t count);
+
+    /**
+     * Call a function once, when objects or eof are available to read.
+     *
+     * The function is called by one of the File threads, so it should only
+     * post the continuation somewhere else.
+     *
+     * @param[in] function function
+     * @return false if objects or eof are already available. Then the
+     *   function is not called.
+     */
+    virtual bool callWhenReadable(std::function<void()> function);
+
+    /**
+     * Range over all objects, e.g. for (auto & ohb : file.objects()).
+     *
+     * The objects are read in batches of up to batchSize. The read queue is
+     * enlarged to batchSize, so the next batch is decoded, while the
+     * current one is processed.
+     *
+     * @param[in] batchSize maximum number of objects per batch
+     * @return range of std::unique_ptr<ObjectHeaderBase>
+     */
+    virtual ObjectRange<ObjectHeaderBase> objects(std::size_t batchSize = 256);
+
+    /**
+     * Range over the objects, that are instances of T.
+     *
+     * Other objects are deleted while reading.
+     *
+     * @see objects
+     *
+     * @tparam T object class, e.g. CanFdMessage64
+     * @param[in] batchSize maximum number of objects per batch
+     * @return range of std::unique_ptr<T>
+     */
+    template <typename T>
+    ObjectRange<T> typed(std::size_t batchSize = 256) {
+        enlargeReadQueue(batchSize);
+        return ObjectRange<T>(*this, batchSize);
+    }
+
     /**
      * Write object to file.
      *
@@ -175,6 +498,45 @@ class VECTOR_BLF_EXPORT File final {
      */
     virtual void write(ObjectHeaderBase * ohb);
 
+    /**
+     * Write objects to file.
+     *
+     * The objects are handed over to the write pipeline at once, with a
+     * single lock and notification, instead of one per object.
+     *
+     * Ownership is taken over from the user to the library.
+     * The vector is empty afterwards.
+     *
+     * @param[in] objects write objects
+     */
+    virtual void write(std::vector<std::unique_ptr<ObjectHeaderBase>> && objects);
+
+    /**
+     * Write objects to file.
+     *
+     * Ownership is taken over from the user to the library.
+     * The objects should not be further accessed any more.
+     *
+     * @param[in] objects write objects, not nullptr
+     * @param[in] count number of objects
+     */
+    virtual void write(ObjectHeaderBase * const * objects, std::size_t count);
+
+    /**
+     * Wait until objects are compressed and written to disk.
+     *
+     * The size is counted from open, including the padding of each object.
+     * Only complete LogContainers are compressed before close or the
+     * maximum flush latency, so wait for a multiple of the
+     * defaultLogContainerSize.
+     *
+     * Returns early, if the file is closed or writing failed.
+     *
+     * @param[in] objectsSize uncompressed size of the objects
+     * @return uncompressed size of the objects written to disk
+     */
+    virtual uint64_t waitForCompressedObjects(uint64_t objectsSize);
+
     /**
      * close file
      */
@@ -194,6 +556,27 @@ class VECTOR_BLF_EXPORT File final {
      */
     virtual void setDefaultLogContainerSize(uint32_t defaultLogContainerSize);
 
+    /**
+     * Get maximum flush latency.
+     *
+     * @return maximum flush latency
+     */
+    virtual std::chrono::milliseconds maxFlushLatency() const;
+
+    /**
+     * Set maximum flush latency.
+     *
+     * During write, a LogContainer is sealed before it's full, when its
+     * oldest object was written this time ago. It's then compressed and
+     * written into the file, so that it's visible to readers following the
+     * file. This creates smaller LogContainers on quiet buses.
+     *
+     * Zero disables it, which is the default.
+     *
+     * @param[in] maxFlushLatency maximum flush latency
+     */
+    virtual void setMaxFlushLatency(std::chrono::milliseconds maxFlushLatency);
+
     /**
      * create object of given type
      *
@@ -233,6 +616,24 @@ class VECTOR_BLF_EXPORT File final {
      */
     UncompressedFile m_uncompressedFile {};
 
+    /**
+     * write cursor into uncompressedFile
+     *
+     * The readWriteThread serializes the objects directly into LogContainers,
+     * that are handed over to uncompressedFile when they are full.
+     */
+    LogContainerWriter m_logContainerWriter {m_uncompressedFile};
+
+    /**
+     * maximum flush latency in milliseconds
+     */
+    std::atomic<std::chrono::milliseconds::rep> m_maxFlushLatency {0};
+
+    /**
+     * time when the current LogContainer of m_logContainerWriter was started
+     */
+    std::chrono::steady_clock::time_point m_unflushedSince {};
+
     /**
      * thread between readWriteQueue and uncompressedFile
      */
@@ -274,13 +675,303 @@ class VECTOR_BLF_EXPORT File final {
      */
     std::atomic<bool> m_compressedFileThreadRunning {};
 
+    /**
+     * uncompressed size of the objects in the LogContainers written to disk
+     */
+    uint64_t m_compressedObjectsSize {};
+
+    /**
+     * mutex for m_compressedObjectsSize
+     */
+    std::mutex m_compressedObjectsMutex {};
+
+    /**
+     * m_compressedObjectsSize changed or compressedFileThread stopped
+     */
+    std::condition_variable m_compressedObjectsChanged {};
+
+    /* progress and cancellation */
+
+    /**
+     * compressed bytes read
+     */
+    std::atomic<uint64_t> m_compressedBytesRead {};
+
+    /**
+     * identity of the file for logContainerCache
+     */
+    LogContainerCache::FileIdentity m_fileIdentity {};
+
+    /**
+     * number of LogContainers read
+     */
+    std::atomic<uint64_t> m_logContainersRead {};
+
+    /**
+     * timestamp in nanoseconds of the object read last
+     */
+    std::atomic<uint64_t> m_readObjectTimeStamp {};
+
+    /**
+     * time of last progressCallback call
+     */
+    std::chrono::steady_clock::time_point m_lastProgressCallback {};
+
+    /**
+     * reading was cancelled
+     */
+    std::atomic<bool> m_cancelled {};
+
+    /**
+     * cancellationToken, at which the File is registered during read
+     */
+    std::shared_ptr<CancellationToken> m_registeredCancellationToken {};
+
+    /**
+     * registration id at m_registeredCancellationToken
+     */
+    uint64_t m_cancellationTokenId {};
+
+    /* metrics */
+
+    /**
+     * inflate metrics, collected with OPTION_USE_METRICS
+     */
+    StageCounters m_inflateCounters {};
+
+    /**
+     * decode metrics per object type, collected with OPTION_USE_METRICS
+     */
+    std::unique_ptr<StageCounters[]> m_decodeCounters {};
+
+    /* recovery */
+
+    /**
+     * skipped byte ranges
+     */
+    std::vector<SkippedRange> m_skippedRanges {};
+
+    /**
+     * uncompressedFile positions, where skipped LogContainers left a gap
+     */
+    std::deque<std::streampos> m_discontinuities {};
+
+    /**
+     * number of resynchronizations
+     */
+    std::atomic<uint64_t> m_resyncCount {};
+
+    /**
+     * mutex for m_skippedRanges and m_discontinuities
+     */
+    mutable std::mutex m_skippedRangesMutex {};
+
+    /* checkpoints */
+
+    /**
+     * time of last checkpoint
+     */
+    std::chrono::steady_clock::time_point m_lastCheckpointTime {};
+
+    /**
+     * file position of last checkpoint
+     */
+    std::streampos m_lastCheckpointPosition {};
+
+    /**
+     * end positions in uncompressedFile of objects, which are not yet in a checkpoint
+     *
+     * This is only maintained if checkpoints are enabled.
+     */
+    std::deque<std::streampos> m_objectEndPositions {};
+
+    /**
+     * mutex for m_objectEndPositions
+     */
+    std::mutex m_objectEndPositionsMutex {};
+
+    /**
+     * position in uncompressedFile up to which data is written into compressedFile
+     */
+    std::streampos m_checkpointUncompressedPosition {};
+
+    /**
+     * number of objects completely written into compressedFile
+     */
+    uint32_t m_checkpointObjectCount {};
+
+    /**
+     * latest timestamp in nanoseconds of the objects written
+     */
+    std::atomic<uint64_t> m_lastObjectTimeStamp {};
+
+    /* restore points */
+
+    /**
+     * restore points of the objects written into compressedFile
+     */
+    RestorePoints m_restorePoints {};
+
+    /**
+     * restore points of objects, which are not yet written into compressedFile
+     *
+     * Until then, compressedFilePosition is the position of the object in uncompressedFile.
+     */
+    std::deque<RestorePoint> m_pendingRestorePoints {};
+
+    /**
+     * mutex for m_pendingRestorePoints
+     */
+    std::mutex m_restorePointsMutex {};
+
     /* internal functions */
 
+    /**
+     * Check if checkpoints are enabled.
+     *
+     * @return true if checkpointInterval or checkpointSize is set
+     */
+    bool checkpointsEnabled() const;
+
+    /**
+     * Set fileStatistics.lastObjectTime from measurementStartTime and the
+     * latest object timestamp.
+     */
+    void setLastObjectTime();
+
+    /**
+     * Write the restore points as RestorePointContainers.
+     *
+     * This is called in close, after the threads are finished.
+     */
+    void writeRestorePointContainers();
+
+    /**
+     * Enlarge the read queue.
+     *
+     * @param[in] bufferSize number of objects
+     */
+    void enlargeReadQueue(std::size_t bufferSize);
+
+    /**
+     * Enlarge the uncompressed file, so that it can hold an object completely.
+     *
+     * @param[in] objectSize object size
+     */
+    void enlargeUncompressedFile(uint32_t objectSize);
+
+    /**
+     * Write a checkpoint, if it's due.
+     *
+     * Updates the file statistics in the header of compressedFile and syncs
+     * it to disk.
+     */
+    void checkpoint();
+
+    /**
+     * Open an existing file for appending, or create a new one.
+     *
+     * @param[in] filename file name
+     */
+    void openAppend(const char * filename);
+
+    /**
+     * Walk over the LogContainers of the compressedFile.
+     *
+     * The walk stops at fileStatistics.restorePointsOffset, if set.
+     * currentUncompressedFileSize is increased by each complete LogContainer.
+     *
+     * @return file position after the last complete LogContainer
+     */
+    std::streampos endOfLastLogContainer();
+
+    /**
+     * Read the RestorePointContainers of an existing file into
+     * m_restorePoints.
+     *
+     * Only complete RestorePoints, that refer to LogContainers before
+     * position, are taken.
+     *
+     * @param[in] position file position of the first LogContainer with
+     *   RestorePointContainers
+     * @return false if they couldn't be read, and m_restorePoints stays empty
+     */
+    bool readRestorePointContainers(std::streampos position);
+
+    /**
+     * Call progressCallback.
+     *
+     * @param[in] force call even if progressInterval has not elapsed
+     */
+    void reportProgress(bool force);
+
     /**
      * Read data from uncompressedFile into readWriteQueue.
      */
     void uncompressedFile2ReadWriteQueue();
 
+    /**
+     * Check if an object header is plausible.
+     *
+     * @param[in] ohb object header
+     * @return true if object header is plausible
+     */
+    bool plausibleObjectHeader(const ObjectHeaderBase & ohb) const;
+
+    /**
+     * Check if a LogContainer header is plausible.
+     *
+     * @param[in] ohb object header
+     * @return true if LogContainer header is plausible
+     */
+    static bool plausibleLogContainerHeader(const ObjectHeaderBase & ohb);
+
+    /**
+     * Add a skipped byte range.
+     *
+     * @param[in] level level
+     * @param[in] position start position
+     * @param[in] size number of skipped bytes
+     */
+    void addSkippedRange(SkippedRange::Level level, uint64_t position, uint64_t size);
+
+    /**
+     * Read object in recovery mode.
+     *
+     * The object is copied into a separate buffer first, so that corrupted
+     * length fields can't read beyond the object.
+     *
+     * @param[in] ohb object header
+     * @param[in] position position of the object
+     */
+    void recoverObject(const ObjectHeaderBase & ohb, std::streampos position);
+
+    /**
+     * Scan uncompressedFile for the next plausible object, starting after position.
+     *
+     * @param[in] position position of the corrupted object
+     */
+    void resyncUncompressedFile(std::streampos position);
+
+    /**
+     * Scan compressedFile for the next plausible LogContainer, starting after position.
+     *
+     * @param[in] position position of the corrupted LogContainer
+     */
+    void resyncCompressedFile(std::streampos position);
+
+    /**
+     * Get the first gap in uncompressedFile within (begin, end).
+     *
+     * Gaps before begin are discarded.
+     *
+     * @param[in] begin begin position
+     * @param[in] end end position
+     * @param[out] discontinuity position of the gap
+     * @return true if there is a gap in the range
+     */
+    bool nextDiscontinuity(std::streampos begin, std::streampos end, std::streampos & discontinuity);
+
     /**
      * Write data from readWriteQueue into uncompressedFile.
      */
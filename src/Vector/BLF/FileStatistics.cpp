@@ -4,6 +4,8 @@
 
 #include "FileStatistics.h"
 
+#include <chrono>
+#include <ctime>
 #include <string>
 
 #include "AbstractFile.h"
@@ -12,6 +14,79 @@
 namespace Vector {
 namespace BLF {
 
+int64_t systemTimeToNs(const SYSTEMTIME & systemTime) {
+    /* days since 1970-01-01 in the proleptic Gregorian calendar */
+    const int64_t month = systemTime.month;
+    const int64_t year = systemTime.year - (month <= 2 ? 1 : 0);
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + systemTime.day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    const int64_t days = era * 146097 + dayOfEra - 719468;
+
+    const int64_t milliseconds =
+        ((days * 24 + systemTime.hour) * 60 + systemTime.minute) * 60000 +
+        systemTime.second * 1000 +
+        systemTime.milliseconds;
+    return milliseconds * 1000000;
+}
+
+SYSTEMTIME nsToSystemTime(int64_t ns) {
+    /* split into days and milliseconds of day */
+    int64_t milliseconds = ns / 1000000;
+    int64_t days = milliseconds / 86400000;
+    milliseconds %= 86400000;
+    if (milliseconds < 0) {
+        milliseconds += 86400000;
+        days--;
+    }
+
+    /* date in the proleptic Gregorian calendar */
+    const int64_t z = days + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t dayOfEra = z - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    const int64_t month = monthIndex + (monthIndex < 10 ? 3 : -9);
+
+    SYSTEMTIME systemTime;
+    systemTime.year = static_cast<uint16_t>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+    systemTime.month = static_cast<uint16_t>(month);
+    systemTime.dayOfWeek = static_cast<uint16_t>(((days % 7) + 11) % 7); // 1970-01-01 was a Thursday
+    systemTime.day = static_cast<uint16_t>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    systemTime.hour = static_cast<uint16_t>(milliseconds / 3600000);
+    systemTime.minute = static_cast<uint16_t>(milliseconds / 60000 % 60);
+    systemTime.second = static_cast<uint16_t>(milliseconds / 1000 % 60);
+    systemTime.milliseconds = static_cast<uint16_t>(milliseconds % 1000);
+    return systemTime;
+}
+
+SYSTEMTIME currentSystemTime() {
+    const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+    const std::time_t time = std::chrono::system_clock::to_time_t(now);
+    const int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+
+    /* local time */
+    std::tm tm {};
+#ifdef _MSC_VER
+    localtime_s(&tm, &time);
+#else
+    localtime_r(&time, &tm);
+#endif
+
+    SYSTEMTIME systemTime;
+    systemTime.year = static_cast<uint16_t>(tm.tm_year + 1900);
+    systemTime.month = static_cast<uint16_t>(tm.tm_mon + 1);
+    systemTime.dayOfWeek = static_cast<uint16_t>(tm.tm_wday);
+    systemTime.day = static_cast<uint16_t>(tm.tm_mday);
+    systemTime.hour = static_cast<uint16_t>(tm.tm_hour);
+    systemTime.minute = static_cast<uint16_t>(tm.tm_min);
+    systemTime.second = static_cast<uint16_t>(tm.tm_sec);
+    systemTime.milliseconds = static_cast<uint16_t>(milliseconds);
+    return systemTime;
+}
+
 void FileStatistics::read(AbstractFile & is) {
     is.read(reinterpret_cast<char *>(&signature), sizeof(signature));
     if (signature != FileSignature)
@@ -97,6 +97,31 @@ struct SYSTEMTIME {
     uint16_t milliseconds;
 };
 
+/**
+ * Convert system time into nanoseconds since 1970-01-01.
+ *
+ * @param[in] systemTime system time
+ * @return nanoseconds since 1970-01-01
+ */
+VECTOR_BLF_EXPORT int64_t systemTimeToNs(const SYSTEMTIME & systemTime);
+
+/**
+ * Convert nanoseconds since 1970-01-01 into system time.
+ *
+ * Nanoseconds below one millisecond are truncated.
+ *
+ * @param[in] ns nanoseconds since 1970-01-01
+ * @return system time
+ */
+VECTOR_BLF_EXPORT SYSTEMTIME nsToSystemTime(int64_t ns);
+
+/**
+ * Get the current local time as system time.
+ *
+ * @return current local time
+ */
+VECTOR_BLF_EXPORT SYSTEMTIME currentSystemTime();
+
 /**
  * File statistics
  */
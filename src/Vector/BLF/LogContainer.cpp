@@ -4,6 +4,8 @@
 
 #include "LogContainer.h"
 
+#include <cstring>
+
 #include <zlib.h>
 
 #include "Exceptions.h"
@@ -16,13 +18,7 @@ LogContainer::LogContainer() :
 }
 
 void LogContainer::read(AbstractFile & is) {
-    ObjectHeaderBase::read(is);
-    is.read(reinterpret_cast<char *>(&compressionMethod), sizeof(compressionMethod));
-    is.read(reinterpret_cast<char *>(&reservedLogContainer1), sizeof(reservedLogContainer1));
-    is.read(reinterpret_cast<char *>(&reservedLogContainer2), sizeof(reservedLogContainer2));
-    is.read(reinterpret_cast<char *>(&uncompressedFileSize), sizeof(uncompressedFileSize));
-    is.read(reinterpret_cast<char *>(&reservedLogContainer3), sizeof(reservedLogContainer3));
-    compressedFileSize = objectSize - internalHeaderSize();
+    readHeader(is);
     compressedFile.resize(compressedFileSize);
     is.read(reinterpret_cast<char *>(compressedFile.data()), compressedFileSize);
 
@@ -30,20 +26,56 @@ void LogContainer::read(AbstractFile & is) {
     is.seekg(objectSize % 4, std::ios_base::cur);
 }
 
+/**
+ * Append a value to a header buffer.
+ *
+ * @param[in,out] p position in header buffer
+ * @param[in] value value
+ */
+template <typename T>
+static void appendHeader(char *& p, const T & value) {
+    std::memcpy(p, &value, sizeof(value));
+    p += sizeof(value);
+}
+
 void LogContainer::write(AbstractFile & os) {
     /* pre processing */
     compressedFileSize = static_cast<uint32_t>(compressedFile.size());
+    headerSize = calculateHeaderSize();
+    objectSize = calculateObjectSize();
+
+    /* assemble headers */
+    char header[32];
+    char * p = header;
+    appendHeader(p, signature);
+    appendHeader(p, headerSize);
+    appendHeader(p, headerVersion);
+    appendHeader(p, objectSize);
+    appendHeader(p, objectType);
+    appendHeader(p, compressionMethod);
+    appendHeader(p, reservedLogContainer1);
+    appendHeader(p, reservedLogContainer2);
+    appendHeader(p, uncompressedFileSize);
+    appendHeader(p, reservedLogContainer3);
+
+    /* write headers, compressed file content and padding at once */
+    static const char padding[4] {};
+    const AbstractFile::WriteBuffer buffers[3] {
+        { header, p - header },
+        { reinterpret_cast<const char *>(compressedFile.data()), compressedFileSize },
+        { padding, objectSize % 4 }
+    };
+    os.writeGather(buffers, 3);
+}
 
-    ObjectHeaderBase::write(os);
-    os.write(reinterpret_cast<char *>(&compressionMethod), sizeof(compressionMethod));
-    os.write(reinterpret_cast<char *>(&reservedLogContainer1), sizeof(reservedLogContainer1));
-    os.write(reinterpret_cast<char *>(&reservedLogContainer2), sizeof(reservedLogContainer2));
-    os.write(reinterpret_cast<char *>(&uncompressedFileSize), sizeof(uncompressedFileSize));
-    os.write(reinterpret_cast<char *>(&reservedLogContainer3), sizeof(reservedLogContainer3));
-    os.write(reinterpret_cast<char *>(compressedFile.data()), compressedFileSize);
-
-    /* skip padding */
-    os.skipp(objectSize % 4);
+void LogContainer::readHeader(AbstractFile & is) {
+    ObjectHeaderBase::read(is);
+    is.read(reinterpret_cast<char *>(&compressionMethod), sizeof(compressionMethod));
+    is.read(reinterpret_cast<char *>(&reservedLogContainer1), sizeof(reservedLogContainer1));
+    is.read(reinterpret_cast<char *>(&reservedLogContainer2), sizeof(reservedLogContainer2));
+    is.read(reinterpret_cast<char *>(&uncompressedFileSize), sizeof(uncompressedFileSize));
+    is.read(reinterpret_cast<char *>(&reservedLogContainer3), sizeof(reservedLogContainer3));
+    compressedFileSize = objectSize - internalHeaderSize();
 }
 
 uint32_t LogContainer::calculateObjectSize() const {
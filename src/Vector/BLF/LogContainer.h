@@ -75,6 +75,16 @@ struct VECTOR_BLF_EXPORT LogContainer final : ObjectHeaderBase {
      */
     uint16_t internalHeaderSize() const;
 
+    /**
+     * Read only the headers of this log container.
+     *
+     * The compressed file content is not read, so the stream is positioned
+     * at its beginning afterwards. compressedFileSize is calculated.
+     *
+     * @param is input stream
+     */
+    virtual void readHeader(AbstractFile & is);
+
     /**
      * uncompress data
      */
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LogContainerCache.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace Vector {
+namespace BLF {
+
+LogContainerCache::LogContainerCache(std::size_t maxSize) :
+    m_maxSize(maxSize) {
+}
+
+bool LogContainerCache::FileIdentity::operator==(const FileIdentity & other) const {
+    return
+        (device == other.device) &&
+        (inode == other.inode) &&
+        (size == other.size) &&
+        (modificationTime == other.modificationTime);
+}
+
+LogContainerCache::FileIdentity LogContainerCache::fileIdentity(const std::string & path) {
+    FileIdentity fileIdentity;
+#ifdef _WIN32
+    struct _stat64 fileStatus;
+    if (::_stat64(path.c_str(), &fileStatus) != 0)
+        return fileIdentity;
+    fileIdentity.modificationTime = static_cast<int64_t>(fileStatus.st_mtime) * 1000000000;
+#else
+    struct stat fileStatus;
+    if (::stat(path.c_str(), &fileStatus) != 0)
+        return fileIdentity;
+#ifdef __APPLE__
+    fileIdentity.modificationTime = static_cast<int64_t>(fileStatus.st_mtimespec.tv_sec) * 1000000000 + fileStatus.st_mtimespec.tv_nsec;
+#else
+    fileIdentity.modificationTime = static_cast<int64_t>(fileStatus.st_mtim.tv_sec) * 1000000000 + fileStatus.st_mtim.tv_nsec;
+#endif
+#endif
+    fileIdentity.device = static_cast<uint64_t>(fileStatus.st_dev);
+    fileIdentity.inode = static_cast<uint64_t>(fileStatus.st_ino);
+    fileIdentity.size = static_cast<uint64_t>(fileStatus.st_size);
+    return fileIdentity;
+}
+
+std::shared_ptr<LogContainerCache> LogContainerCache::forPath(const std::string & path) {
+    /* registry of caches in use */
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<LogContainerCache>> caches;
+
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(mutex);
+
+    /* existing cache */
+    std::shared_ptr<LogContainerCache> cache = caches[path].lock();
+    if (cache)
+        return cache;
+
+    /* new cache, and forget the expired ones */
+    for (auto it = caches.begin(); it != caches.end(); ) {
+        if (it->second.expired())
+            it = caches.erase(it);
+        else
+            ++it;
+    }
+    cache = std::make_shared<LogContainerCache>();
+    caches[path] = cache;
+    return cache;
+}
+
+std::shared_ptr<const LogContainer> LogContainerCache::get(const FileIdentity & fileIdentity, uint64_t position, uint32_t objectSize) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* find entry */
+    auto it = m_positions.find(position);
+    if ((it == m_positions.end()) ||
+            !(it->second->fileIdentity == fileIdentity) ||
+            (it->second->logContainer->objectSize != objectSize)) {
+        m_misses++;
+        return nullptr;
+    }
+
+    /* most recently used */
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    m_hits++;
+    return it->second->logContainer;
+}
+
+void LogContainerCache::put(const FileIdentity & fileIdentity, uint64_t position, const LogContainer & logContainer) {
+    /* copy without compressed data */
+    std::shared_ptr<LogContainer> entry = std::make_shared<LogContainer>();
+    entry->objectSize = logContainer.objectSize;
+    entry->compressionMethod = logContainer.compressionMethod;
+    entry->uncompressedFileSize = logContainer.uncompressedFileSize;
+    entry->compressedFileSize = logContainer.compressedFileSize;
+    entry->uncompressedFile = logContainer.uncompressedFile;
+
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* doesn't fit at all */
+    std::size_t size = entry->uncompressedFile.size();
+    if (size > m_maxSize)
+        return;
+
+    /* replace existing entry */
+    auto it = m_positions.find(position);
+    if (it != m_positions.end()) {
+        m_size -= it->second->logContainer->uncompressedFile.size();
+        m_entries.erase(it->second);
+        m_positions.erase(it);
+    }
+
+    /* insert as most recently used */
+    m_entries.push_front(Entry{fileIdentity, position, entry});
+    m_positions[position] = m_entries.begin();
+    m_size += size;
+    shrink();
+}
+
+void LogContainerCache::clear() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_entries.clear();
+    m_positions.clear();
+    m_size = 0;
+}
+
+std::size_t LogContainerCache::maxSize() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_maxSize;
+}
+
+void LogContainerCache::setMaxSize(std::size_t maxSize) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_maxSize = maxSize;
+    shrink();
+}
+
+std::size_t LogContainerCache::size() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_size;
+}
+
+uint64_t LogContainerCache::hits() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_hits;
+}
+
+uint64_t LogContainerCache::misses() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_misses;
+}
+
+void LogContainerCache::shrink() {
+    while (m_size > m_maxSize) {
+        const Entry & entry = m_entries.back();
+        m_size -= entry.logContainer->uncompressedFile.size();
+        m_positions.erase(entry.position);
+        m_entries.pop_back();
+    }
+}
+
+}
+}
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "LogContainer.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Size-bounded LRU cache of uncompressed LogContainers.
+ *
+ * The LogContainers are identified by their position in the compressed
+ * file and the identity of the file, that readers capture at open. Readers,
+ * that get to the same LogContainer again, take it from the cache instead
+ * of uncompressing it again.
+ *
+ * The file identity consists of device, inode, size and modification time.
+ * A file, that is rewritten in place with the same size within the
+ * resolution of the modification time, is not detected. Files, that are
+ * rewritten while they are read, are not supported.
+ *
+ * A cache can be shared by all Files opened on the same path, see forPath.
+ * The methods are thread-safe.
+ */
+class VECTOR_BLF_EXPORT LogContainerCache final {
+  public:
+    /**
+     * Constructor
+     *
+     * @param[in] maxSize maximum size of the uncompressed data in bytes
+     */
+    explicit LogContainerCache(std::size_t maxSize = 64 * 1024 * 1024);
+    virtual ~LogContainerCache() = default;
+
+    /** identity of a file version */
+    struct VECTOR_BLF_EXPORT FileIdentity {
+        /** device */
+        uint64_t device {};
+
+        /** inode */
+        uint64_t inode {};
+
+        /** file size */
+        uint64_t size {};
+
+        /** modification time in nanoseconds */
+        int64_t modificationTime {};
+
+        /**
+         * Compare file identities.
+         *
+         * @param[in] other other file identity
+         * @return true if identical
+         */
+        bool operator==(const FileIdentity & other) const;
+    };
+
+    /**
+     * Get the identity of a file.
+     *
+     * @param[in] path file path
+     * @return file identity, or a default one, if the file doesn't exist
+     */
+    static FileIdentity fileIdentity(const std::string & path);
+
+    /**
+     * Get the cache of a path.
+     *
+     * All callers with the same path get the same cache, as long as one of
+     * them holds it. The path is compared as given, so use the same
+     * spelling for the same file.
+     *
+     * @param[in] path file path
+     * @return cache
+     */
+    static std::shared_ptr<LogContainerCache> forPath(const std::string & path);
+
+    /**
+     * Get an uncompressed LogContainer.
+     *
+     * The LogContainer is only returned, if the file identity and its
+     * objectSize match, so a cache entry of a file, that was written again,
+     * is not used.
+     *
+     * @param[in] fileIdentity identity of the file captured at open
+     * @param[in] position position of the LogContainer in the compressed file
+     * @param[in] objectSize objectSize of the LogContainer
+     * @return LogContainer with uncompressedFile, or nullptr if not cached
+     */
+    virtual std::shared_ptr<const LogContainer> get(const FileIdentity & fileIdentity, uint64_t position, uint32_t objectSize);
+
+    /**
+     * Put an uncompressed LogContainer into the cache.
+     *
+     * The least recently used LogContainers are dropped, if maxSize is
+     * exceeded. The compressed data is not kept.
+     *
+     * @param[in] fileIdentity identity of the file captured at open
+     * @param[in] position position of the LogContainer in the compressed file
+     * @param[in] logContainer LogContainer with uncompressedFile
+     */
+    virtual void put(const FileIdentity & fileIdentity, uint64_t position, const LogContainer & logContainer);
+
+    /** drop all LogContainers */
+    virtual void clear();
+
+    /**
+     * Get maximum size.
+     *
+     * @return maximum size of the uncompressed data in bytes
+     */
+    virtual std::size_t maxSize() const;
+
+    /**
+     * Set maximum size.
+     *
+     * @param[in] maxSize maximum size of the uncompressed data in bytes
+     */
+    virtual void setMaxSize(std::size_t maxSize);
+
+    /**
+     * Get size.
+     *
+     * @return size of the uncompressed data in bytes
+     */
+    virtual std::size_t size() const;
+
+    /**
+     * Get number of successful gets.
+     *
+     * @return number of hits
+     */
+    virtual uint64_t hits() const;
+
+    /**
+     * Get number of failed gets.
+     *
+     * @return number of misses
+     */
+    virtual uint64_t misses() const;
+
+  private:
+    /** cached LogContainer */
+    struct Entry {
+        /** identity of the file */
+        FileIdentity fileIdentity;
+
+        /** position in the compressed file */
+        uint64_t position;
+
+        /** uncompressed LogContainer */
+        std::shared_ptr<const LogContainer> logContainer;
+    };
+
+    /** mutex */
+    mutable std::mutex m_mutex {};
+
+    /** entries, most recently used first */
+    std::list<Entry> m_entries {};
+
+    /** entries by position */
+    std::map<uint64_t, std::list<Entry>::iterator> m_positions {};
+
+    /** maximum size */
+    std::size_t m_maxSize;
+
+    /** size */
+    std::size_t m_size {};
+
+    /** number of hits */
+    uint64_t m_hits {};
+
+    /** number of misses */
+    uint64_t m_misses {};
+
+    /** drop least recently used entries, until maxSize is met */
+    void shrink();
+};
+
+}
+}
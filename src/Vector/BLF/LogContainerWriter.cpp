@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LogContainerWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Vector {
+namespace BLF {
+
+LogContainerWriter::LogContainerWriter(UncompressedFile & uncompressedFile) :
+    m_uncompressedFile(uncompressedFile) {
+}
+
+std::streamsize LogContainerWriter::gcount() const {
+    return 0;
+}
+
+void LogContainerWriter::read(char * /*s*/, std::streamsize /*n*/) {
+    m_fail = true;
+}
+
+std::streampos LogContainerWriter::tellg() {
+    return -1;
+}
+
+void LogContainerWriter::seekg(std::streamoff /*off*/, const std::ios_base::seekdir /*way*/) {
+    m_fail = true;
+}
+
+void LogContainerWriter::write(const char * s, std::streamsize n) {
+    while (n > 0) {
+        /* start new log container at the end of uncompressedFile */
+        if (!m_logContainer) {
+            m_logContainer = std::make_shared<LogContainer>();
+            m_logContainer->uncompressedFile.resize(m_uncompressedFile.defaultLogContainerSize());
+            m_logContainer->filePosition = m_uncompressedFile.tellp();
+            m_offset = 0;
+        }
+
+        /* copy data */
+        uint32_t size = static_cast<uint32_t>(std::min<std::streamsize>(n, m_logContainer->uncompressedFile.size() - m_offset));
+        std::memcpy(m_logContainer->uncompressedFile.data() + m_offset, s, size);
+        m_offset += size;
+        s += size;
+        n -= size;
+
+        /* hand over full log container */
+        if (m_offset == m_logContainer->uncompressedFile.size())
+            seal();
+    }
+}
+
+std::streampos LogContainerWriter::tellp() {
+    if (!m_logContainer)
+        return m_uncompressedFile.tellp();
+    return m_logContainer->filePosition + static_cast<std::streamoff>(m_offset);
+}
+
+bool LogContainerWriter::good() const {
+    return !m_fail;
+}
+
+bool LogContainerWriter::eof() const {
+    return false;
+}
+
+void LogContainerWriter::seal() {
+    if (!m_logContainer)
+        return;
+
+    /* hand over the filled part */
+    m_logContainer->uncompressedFile.resize(m_offset);
+    m_logContainer->uncompressedFileSize = m_offset;
+    if (m_offset > 0)
+        m_uncompressedFile.write(m_logContainer);
+    m_logContainer.reset();
+    m_offset = 0;
+}
+
+bool LogContainerWriter::empty() const {
+    return m_offset == 0;
+}
+
+uint32_t LogContainerWriter::available() const {
+    if (!m_logContainer)
+        return m_uncompressedFile.defaultLogContainerSize();
+    return static_cast<uint32_t>(m_logContainer->uncompressedFile.size()) - m_offset;
+}
+
+}
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <memory>
+
+#include "AbstractFile.h"
+#include "LogContainer.h"
+#include "UncompressedFile.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Write cursor, that serializes objects directly into LogContainers.
+ *
+ * The data is appended to a LogContainer of defaultLogContainerSize, which
+ * is owned by the writer. There is no locking, waiting or searching per
+ * field. When the LogContainer is full, or seal is called, it's handed over
+ * to the UncompressedFile, without copying its data.
+ *
+ * This class is not thread-safe. It's used by the thread writing into the
+ * UncompressedFile only.
+ */
+class VECTOR_BLF_EXPORT LogContainerWriter final : public AbstractFile {
+  public:
+    /**
+     * @param[in] uncompressedFile destination of the sealed LogContainers
+     */
+    explicit LogContainerWriter(UncompressedFile & uncompressedFile);
+
+    /** not supported, always 0 */
+    std::streamsize gcount() const override;
+
+    /** not supported, sets failure */
+    void read(char * s, std::streamsize n) override;
+
+    /** not supported, always -1 */
+    std::streampos tellg() override;
+
+    /** not supported, sets failure */
+    void seekg(std::streamoff off, const std::ios_base::seekdir way = std::ios_base::cur) override;
+
+    void write(const char * s, std::streamsize n) override;
+    std::streampos tellp() override;
+    bool good() const override;
+    bool eof() const override;
+
+    /**
+     * Hand over the current LogContainer, even if it's not full.
+     */
+    virtual void seal();
+
+    /**
+     * Check if there is data, that is not handed over yet.
+     *
+     * @return true if the current LogContainer is empty
+     */
+    virtual bool empty() const;
+
+    /**
+     * Free space in the current LogContainer.
+     *
+     * @return number of bytes, that can be written before it's handed over
+     */
+    virtual uint32_t available() const;
+
+  private:
+    /** destination */
+    UncompressedFile & m_uncompressedFile;
+
+    /** current LogContainer */
+    std::shared_ptr<LogContainer> m_logContainer {};
+
+    /** number of bytes written into current LogContainer */
+    uint32_t m_offset {};
+
+    /** failure */
+    bool m_fail {false};
+};
+
+}
+}
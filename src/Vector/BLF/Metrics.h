@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Counters and timer of a pipeline stage.
+ */
+struct VECTOR_BLF_EXPORT StageMetrics {
+    /** number of operations, e.g. LogContainers or objects */
+    uint64_t count {};
+
+    /** number of bytes processed */
+    uint64_t bytes {};
+
+    /** time spent */
+    std::chrono::nanoseconds time {};
+};
+
+/**
+ * Wait times and fill level of a queue between two pipeline stages.
+ */
+struct VECTOR_BLF_EXPORT QueueMetrics {
+    /** time the consumer waited for data */
+    std::chrono::nanoseconds readWaitTime {};
+
+    /** time the producer waited for free space */
+    std::chrono::nanoseconds writeWaitTime {};
+
+    /** maximum fill level, in the unit of the queue */
+    uint64_t highWaterMark {};
+};
+
+/**
+ * Metrics of the File pipeline.
+ *
+ * They are only collected, if the library is built with
+ * OPTION_USE_METRICS. Otherwise enabled is false and all values are zero.
+ */
+struct VECTOR_BLF_EXPORT Metrics {
+    /** metrics are collected */
+    bool enabled {};
+
+    /** CompressedFile::read, i.e. disk I/O: calls, bytes, time blocked */
+    StageMetrics compressedFileRead {};
+
+    /** inflate: LogContainers, uncompressed bytes, time */
+    StageMetrics inflate {};
+
+    /**
+     * decode per object type: objects, bytes, time
+     *
+     * The time includes waiting for the rest of the object, if it spans
+     * several LogContainers.
+     */
+    std::map<ObjectType, StageMetrics> decode {};
+
+    /** UncompressedFile, between inflate and decode (bytes) */
+    QueueMetrics uncompressedFile {};
+
+    /** ObjectQueue, between decode and the consumer (objects) */
+    QueueMetrics objectQueue {};
+};
+
+/**
+ * Thread-safe counters of a pipeline stage.
+ *
+ * They are updated by the thread of the stage and read by others.
+ */
+class VECTOR_BLF_EXPORT StageCounters final {
+  public:
+    /**
+     * Count an operation.
+     *
+     * @param[in] bytes number of bytes processed
+     * @param[in] time time spent
+     */
+    void add(uint64_t bytes, std::chrono::nanoseconds time) {
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        m_time.fetch_add(static_cast<uint64_t>(time.count()), std::memory_order_relaxed);
+    }
+
+    /** @return snapshot of the counters */
+    StageMetrics metrics() const {
+        StageMetrics metrics;
+        metrics.count = m_count.load(std::memory_order_relaxed);
+        metrics.bytes = m_bytes.load(std::memory_order_relaxed);
+        metrics.time = std::chrono::nanoseconds(m_time.load(std::memory_order_relaxed));
+        return metrics;
+    }
+
+  private:
+    /** number of operations */
+    std::atomic<uint64_t> m_count {};
+
+    /** number of bytes */
+    std::atomic<uint64_t> m_bytes {};
+
+    /** time in nanoseconds */
+    std::atomic<uint64_t> m_time {};
+};
+
+/**
+ * Wait on a condition variable until predicate is true.
+ *
+ * If the library is built with OPTION_USE_METRICS, the time is added to
+ * waitTime. Otherwise it's a plain wait.
+ *
+ * @param[in] condition condition variable
+ * @param[in] lock locked mutex
+ * @param[in] predicate predicate
+ * @param[in,out] waitTime wait time
+ */
+template <typename Predicate>
+void timedWait(std::condition_variable & condition, std::unique_lock<std::mutex> & lock, Predicate predicate, std::chrono::nanoseconds & waitTime) {
+#ifdef VECTOR_BLF_USE_METRICS
+    if (predicate())
+        return;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    condition.wait(lock, predicate);
+    waitTime += std::chrono::steady_clock::now() - start;
+#else
+    (void) waitTime;
+    condition.wait(lock, predicate);
+#endif
+}
+
+}
+}
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "MultiFileReader.h"
+
+#include <algorithm>
+
+#include "Exceptions.h"
+
+namespace Vector {
+namespace BLF {
+
+MultiFileReader::~MultiFileReader() {
+    close();
+}
+
+void MultiFileReader::open(const std::vector<std::string> & filenames) {
+    /* check */
+    if (!m_files.empty())
+        throw Exception("MultiFileReader::open(): Files are already open.");
+
+    /* open all files, which starts their read threads */
+    for (const std::string & filename : filenames) {
+        std::unique_ptr<File> file(new File);
+        file->open(filename, std::ios_base::in);
+        m_files.push_back(std::move(file));
+    }
+
+    /* offset to earliest measurementStartTime, files without one are not shifted */
+    std::vector<int64_t> startTimes;
+    for (const std::unique_ptr<File> & file : m_files) {
+        const SYSTEMTIME & measurementStartTime = file->fileStatistics.measurementStartTime;
+        startTimes.push_back((measurementStartTime.year != 0) ? systemTimeToNs(measurementStartTime) : -1);
+    }
+    int64_t earliestStartTime = -1;
+    for (int64_t startTime : startTimes)
+        if ((startTime >= 0) && ((earliestStartTime < 0) || (startTime < earliestStartTime)))
+            earliestStartTime = startTime;
+    for (int64_t startTime : startTimes)
+        m_timeStampOffsets.push_back((startTime >= 0) ? static_cast<uint64_t>(startTime - earliestStartTime) : 0);
+
+    /* prefill heap */
+    for (std::size_t source = 0; source < m_files.size(); ++source)
+        if (m_files[source]->is_open())
+            fill(source);
+}
+
+bool MultiFileReader::is_open() const {
+    if (m_files.empty())
+        return false;
+
+    return std::all_of(m_files.cbegin(), m_files.cend(), [](const std::unique_ptr<File> & file) {
+        return file->is_open();
+    });
+}
+
+ObjectHeaderBase * MultiFileReader::read(std::size_t & source) {
+    if (m_heap.empty())
+        return nullptr;
+
+    /* take the earliest object */
+    std::pop_heap(m_heap.begin(), m_heap.end(), later);
+    Entry entry = m_heap.back();
+    m_heap.pop_back();
+
+    /* replace it by the next object of the same file */
+    fill(entry.source);
+
+    source = entry.source;
+    return entry.ohb;
+}
+
+ObjectHeaderBase * MultiFileReader::read() {
+    std::size_t source;
+    return read(source);
+}
+
+void MultiFileReader::close() {
+    /* delete objects, that were not read */
+    for (Entry & entry : m_heap)
+        delete entry.ohb;
+    m_heap.clear();
+
+    /* close files */
+    for (std::unique_ptr<File> & file : m_files)
+        file->close();
+    m_files.clear();
+    m_timeStampOffsets.clear();
+}
+
+std::size_t MultiFileReader::size() const {
+    return m_files.size();
+}
+
+File & MultiFileReader::file(std::size_t index) {
+    return *m_files.at(index);
+}
+
+uint64_t MultiFileReader::timeStampOffset(std::size_t index) const {
+    return m_timeStampOffsets.at(index);
+}
+
+void MultiFileReader::fill(std::size_t source) {
+    /* skip restore point containers */
+    ObjectHeaderBase * ohb = m_files[source]->read();
+    while ((ohb != nullptr) && (ohb->objectType == ObjectType::Unknown115)) {
+        delete ohb;
+        ohb = m_files[source]->read();
+    }
+    if (ohb == nullptr)
+        return;
+
+    Entry entry;
+    entry.timeStamp = objectTimeStampNs(*ohb) + m_timeStampOffsets[source];
+    entry.source = source;
+    entry.ohb = ohb;
+    m_heap.push_back(entry);
+    std::push_heap(m_heap.begin(), m_heap.end(), later);
+}
+
+bool MultiFileReader::later(const Entry & lhs, const Entry & rhs) {
+    if (lhs.timeStamp != rhs.timeStamp)
+        return lhs.timeStamp > rhs.timeStamp;
+    return lhs.source > rhs.source;
+}
+
+}
+}
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "File.h"
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Reads multiple files as one stream, ordered by object timestamp.
+ *
+ * Each file is read by its own File, so all files are decompressed and
+ * parsed in parallel. The objects are merged with a heap on the normalized
+ * object timestamp, which is the object timestamp in nanoseconds plus the
+ * offset of the file's measurementStartTime to the earliest
+ * measurementStartTime of all files. Objects with equal timestamps are
+ * returned in the order of the files.
+ *
+ * RestorePointContainers are skipped, as they have no timestamp.
+ */
+class VECTOR_BLF_EXPORT MultiFileReader final {
+  public:
+    MultiFileReader() = default;
+    virtual ~MultiFileReader();
+
+    /**
+     * open files
+     *
+     * @param[in] filenames file names
+     */
+    virtual void open(const std::vector<std::string> & filenames);
+
+    /**
+     * is all files open?
+     *
+     * @return true if all files are open
+     */
+    virtual bool is_open() const;
+
+    /**
+     * Read the next object in timestamp order.
+     *
+     * @param[out] source index of the file the object was read from
+     * @return read object or nullptr at end of all files
+     */
+    virtual ObjectHeaderBase * read(std::size_t & source);
+
+    /**
+     * Read the next object in timestamp order.
+     *
+     * @return read object or nullptr at end of all files
+     */
+    virtual ObjectHeaderBase * read();
+
+    /**
+     * close files
+     */
+    virtual void close();
+
+    /**
+     * Get number of files.
+     *
+     * @return number of files
+     */
+    virtual std::size_t size() const;
+
+    /**
+     * Get access to a file, e.g. for its fileStatistics.
+     *
+     * @param[in] index file index
+     * @return file
+     */
+    virtual File & file(std::size_t index);
+
+    /**
+     * Get the offset of a file's measurementStartTime to the earliest
+     * measurementStartTime of all files.
+     *
+     * @param[in] index file index
+     * @return offset in nanoseconds
+     */
+    virtual uint64_t timeStampOffset(std::size_t index) const;
+
+  private:
+    /** heap entry */
+    struct Entry {
+        /** normalized timestamp */
+        uint64_t timeStamp;
+
+        /** file index */
+        std::size_t source;
+
+        /** object */
+        ObjectHeaderBase * ohb;
+    };
+
+    /** files */
+    std::vector<std::unique_ptr<File>> m_files {};
+
+    /** offset of measurementStartTime per file */
+    std::vector<uint64_t> m_timeStampOffsets {};
+
+    /** heap with the next object of each file */
+    std::vector<Entry> m_heap {};
+
+    /**
+     * Read next object from a file into the heap.
+     *
+     * @param[in] source file index
+     */
+    void fill(std::size_t source);
+
+    /**
+     * Heap ordering, that puts the smallest timestamp on top.
+     *
+     * @param[in] lhs left hand side
+     * @param[in] rhs right hand side
+     * @return true if lhs comes after rhs
+     */
+    static bool later(const Entry & lhs, const Entry & rhs);
+};
+
+}
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ObjectDispatch.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Convert timestamp into nanoseconds.
+ *
+ * @param[in] objectFlags object flags
+ * @param[in] objectTimeStamp object timestamp
+ * @return object timestamp in nanoseconds
+ */
+static uint64_t timeStampNs(const uint32_t objectFlags, const uint64_t objectTimeStamp) {
+    if (objectFlags & ObjectHeader::ObjectFlags::TimeTenMics)
+        return objectTimeStamp * 10000;
+    return objectTimeStamp;
+}
+
+/** visitor that returns the object timestamp in nanoseconds */
+struct ObjectTimeStampVisitor {
+    uint64_t operator()(const ObjectHeader & oh) const {
+        return timeStampNs(oh.objectFlags, oh.objectTimeStamp);
+    }
+
+    uint64_t operator()(const ObjectHeader2 & oh) const {
+        return timeStampNs(oh.objectFlags, oh.objectTimeStamp);
+    }
+
+    uint64_t operator()(const VarObjectHeader & oh) const {
+        return timeStampNs(oh.objectFlags, oh.objectTimeStamp);
+    }
+
+    uint64_t operator()(const ObjectHeaderBase &) const {
+        return 0;
+    }
+};
+
+uint64_t objectTimeStampNs(const ObjectHeaderBase & ohb) {
+    return dispatch(ohb, ObjectTimeStampVisitor());
+}
+
+}
+}
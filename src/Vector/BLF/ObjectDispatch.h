@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <type_traits>
+
+#include "ObjectHeader.h"
+#include "ObjectHeader2.h"
+#include "ObjectHeaderBase.h"
+#include "VarObjectHeader.h"
+
+#include "AppTrigger.h"
+#include "AttributeEvent.h"
+#include "CanDriverError.h"
+#include "CanDriverErrorExt.h"
+#include "CanDriverHwSync.h"
+#include "CanDriverStatistic.h"
+#include "CanErrorFrame.h"
+#include "CanErrorFrameExt.h"
+#include "CanFdErrorFrame64.h"
+#include "CanFdMessage.h"
+#include "CanFdMessage64.h"
+#include "CanMessage.h"
+#include "CanMessage2.h"
+#include "CanOverloadFrame.h"
+#include "CanSettingChanged.h"
+#include "DataLostBegin.h"
+#include "DataLostEnd.h"
+#include "DiagRequestInterpretation.h"
+#include "DistributedObjectMember.h"
+#include "DriverOverrun.h"
+#include "EnvironmentVariable.h"
+#include "EventComment.h"
+#include "FunctionBus.h"
+#include "GlobalMarker.h"
+#include "GpsEvent.h"
+#include "LogContainer.h"
+#include "RealtimeClock.h"
+#include "RestorePointContainer.h"
+#include "SerialEvent.h"
+#include "TestStructure.h"
+#include "TriggerCondition.h"
+#include "WaterMarkEvent.h"
+
+#include "vector_blf_export.h"
+
+/**
+ * List of all object types, that are supported by this library,
+ * together with the class that represents them.
+ *
+ * The list is expanded with a macro X(objectType, className) to generate
+ * the type traits, the dispatch switch and File::createObject.
+ */
+#define VECTOR_BLF_OBJECT_TYPES(X) \
+    X(CAN_MESSAGE, CanMessage) \
+    X(CAN_ERROR, CanErrorFrame) \
+    X(CAN_OVERLOAD, CanOverloadFrame) \
+    X(CAN_STATISTIC, CanDriverStatistic) \
+    X(APP_TRIGGER, AppTrigger) \
+    X(ENV_INTEGER, EnvironmentVariable) \
+    X(ENV_DOUBLE, EnvironmentVariable) \
+    X(ENV_STRING, EnvironmentVariable) \
+    X(ENV_DATA, EnvironmentVariable) \
+    X(LOG_CONTAINER, LogContainer) \
+    X(CAN_DRIVER_SYNC, CanDriverHwSync) \
+    X(GPS_EVENT, GpsEvent) \
+    X(REALTIMECLOCK, RealtimeClock) \
+    X(CAN_ERROR_EXT, CanErrorFrameExt) \
+    X(CAN_DRIVER_ERROR_EXT, CanDriverErrorExt) \
+    X(CAN_MESSAGE2, CanMessage2) \
+    X(SERIAL_EVENT, SerialEvent) \
+    X(OVERRUN_ERROR, DriverOverrun) \
+    X(EVENT_COMMENT, EventComment) \
+    X(GLOBAL_MARKER, GlobalMarker) \
+    X(CAN_FD_MESSAGE, CanFdMessage) \
+    X(CAN_FD_MESSAGE_64, CanFdMessage64) \
+    X(CAN_FD_ERROR_64, CanFdErrorFrame64) \
+    X(Unknown115, RestorePointContainer) \
+    X(TEST_STRUCTURE, TestStructure) \
+    X(DIAG_REQUEST_INTERPRETATION, DiagRequestInterpretation) \
+    X(FUNCTION_BUS, FunctionBus) \
+    X(DATA_LOST_BEGIN, DataLostBegin) \
+    X(DATA_LOST_END, DataLostEnd) \
+    X(WATER_MARK_EVENT, WaterMarkEvent) \
+    X(TRIGGER_CONDITION, TriggerCondition) \
+    X(CAN_SETTING_CHANGED, CanSettingChanged) \
+    X(DISTRIBUTED_OBJECT_MEMBER, DistributedObjectMember) \
+    X(ATTRIBUTE_EVENT, AttributeEvent)
+
+namespace Vector {
+namespace BLF {
+
+/** list of all object types supported by this library */
+#define VECTOR_BLF_SUPPORTED_OBJECT_TYPE(objectType, className) ObjectType::objectType,
+constexpr ObjectType SupportedObjectTypes[] = {
+    VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_SUPPORTED_OBJECT_TYPE)
+};
+#undef VECTOR_BLF_SUPPORTED_OBJECT_TYPE
+
+/**
+ * Check if an object type is supported by this library.
+ *
+ * @param[in] objectType object type
+ * @return true if object type is supported
+ */
+constexpr bool isSupportedObjectType(const ObjectType objectType) {
+#define VECTOR_BLF_SUPPORTED_OBJECT_TYPE(type, className) (objectType == ObjectType::type) ||
+    return VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_SUPPORTED_OBJECT_TYPE) false;
+#undef VECTOR_BLF_SUPPORTED_OBJECT_TYPE
+}
+
+/**
+ * Check if objects of an object type are instances of a class.
+ *
+ * This is also true for base classes, e.g. ObjectHeader.
+ *
+ * @tparam T class
+ * @param[in] objectType object type
+ * @return true if the class representing the object type is T or derived from T
+ */
+template <typename T>
+constexpr bool isInstanceOf(const ObjectType objectType) {
+#define VECTOR_BLF_INSTANCE_OF(type, className) ((objectType == ObjectType::type) && std::is_base_of<T, className>::value) ||
+    return VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_INSTANCE_OF) false;
+#undef VECTOR_BLF_INSTANCE_OF
+}
+
+/**
+ * Maps an object type to the class representing it.
+ *
+ * The primary template is used for unsupported object types, which are
+ * represented by ObjectHeaderBase. ObjectClass<...>::value is true for
+ * supported object types.
+ *
+ * @tparam objectType object type
+ */
+template <ObjectType objectType>
+struct ObjectClass : std::false_type {
+    /** class representing the object type */
+    using type = ObjectHeaderBase;
+};
+
+#define VECTOR_BLF_OBJECT_CLASS(objectType, className) \
+    template <> \
+    struct ObjectClass<ObjectType::objectType> : std::true_type { \
+        using type = className; \
+    };
+VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_OBJECT_CLASS)
+#undef VECTOR_BLF_OBJECT_CLASS
+
+/**
+ * Call a function object with the object downcasted to its concrete class.
+ *
+ * The concrete class is selected by a switch on objectType, so no RTTI is
+ * involved and the compiler can inline the per-type handling.
+ * The function object needs to accept all classes listed in
+ * VECTOR_BLF_OBJECT_TYPES, e.g. a template operator() or a generic lambda.
+ * Objects of unsupported types are passed as ObjectHeaderBase.
+ *
+ * @note The object must have been created with the class matching its
+ *   objectType, e.g. by File::createObject or File::read.
+ *
+ * @param[in] ohb object
+ * @param[in] f function object
+ * @return return value of f
+ */
+template <typename F>
+auto dispatch(ObjectHeaderBase & ohb, F && f) -> decltype(f(ohb)) {
+    switch (ohb.objectType) {
+#define VECTOR_BLF_DISPATCH_CASE(objectType, className) \
+    case ObjectType::objectType: \
+        return f(static_cast<className &>(ohb));
+    VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_DISPATCH_CASE)
+#undef VECTOR_BLF_DISPATCH_CASE
+
+    default:
+        break;
+    }
+
+    return f(ohb);
+}
+
+/** @copydoc dispatch(ObjectHeaderBase &, F &&) */
+template <typename F>
+auto dispatch(const ObjectHeaderBase & ohb, F && f) -> decltype(f(ohb)) {
+    switch (ohb.objectType) {
+#define VECTOR_BLF_DISPATCH_CASE(objectType, className) \
+    case ObjectType::objectType: \
+        return f(static_cast<const className &>(ohb));
+    VECTOR_BLF_OBJECT_TYPES(VECTOR_BLF_DISPATCH_CASE)
+#undef VECTOR_BLF_DISPATCH_CASE
+
+    default:
+        break;
+    }
+
+    return f(ohb);
+}
+
+/**
+ * Get the object timestamp in nanoseconds.
+ *
+ * The timestamp is converted according to objectFlags (TimeTenMics or
+ * TimeOneNans). Objects without timestamp, e.g. LogContainer, return 0.
+ *
+ * @param[in] ohb object
+ * @return object timestamp in nanoseconds
+ */
+VECTOR_BLF_EXPORT uint64_t objectTimeStampNs(const ObjectHeaderBase & ohb);
+
+}
+}
@@ -27,16 +27,131 @@ T * ObjectQueue<T>::read() {
     std::unique_lock<std::mutex> lock(m_mutex);
 
     /* wait for data */
-    tellpChanged.wait(lock, [&] {
-        return
+    timedWait(tellpChanged, lock, [&] {
+        return readable();
+    }, m_metrics.readWaitTime);
+
+    return dequeue();
+}
+
+template<typename T>
+T * ObjectQueue<T>::read(const std::chrono::steady_clock::time_point & deadline) {
+    /* mutex lock */
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    /* wait for data */
+#ifdef VECTOR_BLF_USE_METRICS
+    std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+#endif
+    bool available = tellpChanged.wait_until(lock, deadline, [&] {
+        return readable();
+    });
+#ifdef VECTOR_BLF_USE_METRICS
+    m_metrics.readWaitTime += std::chrono::steady_clock::now() - waitStart;
+#endif
+
+    /* timeout */
+    if (!available) {
+        m_rdstate = std::ios_base::goodbit;
+        return nullptr;
+    }
+
+    return dequeue();
+}
+
+template<typename T>
+std::size_t ObjectQueue<T>::read(T ** objs, std::size_t count) {
+    /* mutex lock */
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    /* wait for data */
+    timedWait(tellpChanged, lock, [&] {
+        return readable();
+    }, m_metrics.readWaitTime);
+
+    /* get entries */
+    std::size_t n = 0;
+    while (!m_abort && (n < count) && !m_queue.empty()) {
+        objs[n++] = m_queue.front();
+        m_queue.pop();
+    }
+
+    /* set state */
+    if ((n == 0) && (count > 0))
+        m_rdstate = std::ios_base::eofbit | std::ios_base::failbit;
+    else
+        m_rdstate = std::ios_base::goodbit;
+
+    /* increase get count */
+    m_tellg += static_cast<uint32_t>(n);
+
+    /* notify */
+    tellgChanged.notify_all();
+
+    return n;
+}
+
+template<typename T>
+std::size_t ObjectQueue<T>::tryRead(T ** objs, std::size_t count) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* get entries */
+    std::size_t n = 0;
+    while (!m_abort && (n < count) && !m_queue.empty()) {
+        objs[n++] = m_queue.front();
+        m_queue.pop();
+    }
+
+    /* set state */
+    if ((n == 0) && readable())
+        m_rdstate = std::ios_base::eofbit | std::ios_base::failbit;
+    else
+        m_rdstate = std::ios_base::goodbit;
+
+    /* increase get count */
+    m_tellg += static_cast<uint32_t>(n);
+
+    /* notify */
+    if (n > 0)
+        tellgChanged.notify_all();
+
+    return n;
+}
+
+template<typename T>
+bool ObjectQueue<T>::callWhenReadable(std::function<void()> function) {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (readable())
+        return false;
+    m_whenReadable = std::move(function);
+    return true;
+}
+
+template<typename T>
+bool ObjectQueue<T>::readable() const {
+    return
         m_abort ||
         !m_queue.empty() ||
         (m_tellg >= m_fileSize);
-    });
+}
+
+template<typename T>
+void ObjectQueue<T>::notifyReadable(std::unique_lock<std::mutex> & lock) {
+    std::function<void()> function;
+    function.swap(m_whenReadable);
+    lock.unlock();
+    if (function)
+        function();
+}
 
+template<typename T>
+T * ObjectQueue<T>::dequeue() {
     /* get first entry */
     T * ohb = nullptr;
-    if (m_queue.empty())
+    if (m_abort || m_queue.empty())
         m_rdstate = std::ios_base::eofbit | std::ios_base::failbit;
     else {
         ohb = m_queue.front();
@@ -69,11 +184,11 @@ void ObjectQueue<T>::write(T * obj) {
     std::unique_lock<std::mutex> lock(m_mutex);
 
     /* wait for free space */
-    tellgChanged.wait(lock, [&] {
+    timedWait(tellgChanged, lock, [&] {
         return
         m_abort ||
         static_cast<uint32_t>(m_queue.size()) < m_bufferSize;
-    });
+    }, m_metrics.writeWaitTime);
 
     /* push data */
     m_queue.push(obj);
@@ -85,8 +200,49 @@ void ObjectQueue<T>::write(T * obj) {
     if (m_tellp > m_fileSize)
         m_fileSize = m_tellp;
 
+#ifdef VECTOR_BLF_USE_METRICS
+    /* fill level */
+    if (m_queue.size() > m_metrics.highWaterMark)
+        m_metrics.highWaterMark = m_queue.size();
+#endif
+
     /* notify */
     tellpChanged.notify_all();
+    notifyReadable(lock);
+}
+
+template<typename T>
+void ObjectQueue<T>::write(T * const * objs, std::size_t count) {
+    /* mutex lock */
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    /* wait for free space */
+    timedWait(tellgChanged, lock, [&] {
+        return
+        m_abort ||
+        static_cast<uint32_t>(m_queue.size()) < m_bufferSize;
+    }, m_metrics.writeWaitTime);
+
+    /* push data */
+    for (std::size_t i = 0; i < count; ++i)
+        m_queue.push(objs[i]);
+
+    /* increase put count */
+    m_tellp += static_cast<uint32_t>(count);
+
+    /* shift eof */
+    if (m_tellp > m_fileSize)
+        m_fileSize = m_tellp;
+
+#ifdef VECTOR_BLF_USE_METRICS
+    /* fill level */
+    if (m_queue.size() > m_metrics.highWaterMark)
+        m_metrics.highWaterMark = m_queue.size();
+#endif
+
+    /* notify */
+    tellpChanged.notify_all();
+    notifyReadable(lock);
 }
 
 template<typename T>
@@ -116,7 +272,7 @@ bool ObjectQueue<T>::eof() const {
 template<typename T>
 void ObjectQueue<T>::abort() {
     /* mutex lock */
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
 
     /* stop */
     m_abort = true;
@@ -124,18 +280,20 @@ void ObjectQueue<T>::abort() {
     /* trigger blocked threads */
     tellgChanged.notify_all();
     tellpChanged.notify_all();
+    notifyReadable(lock);
 }
 
 template<typename T>
 void ObjectQueue<T>::setFileSize(uint32_t fileSize) {
     /* mutex lock */
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
 
     /* set object count */
     m_fileSize = fileSize;
 
     /* notify */
     tellpChanged.notify_all();
+    notifyReadable(lock);
 }
 
 template<typename T>
@@ -147,6 +305,14 @@ void ObjectQueue<T>::setBufferSize(uint32_t bufferSize) {
     m_bufferSize = bufferSize;
 }
 
+template<typename T>
+QueueMetrics ObjectQueue<T>::metrics() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_metrics;
+}
+
 template class ObjectQueue<ObjectHeaderBase>;
 
 }
@@ -6,13 +6,17 @@
 
 #include "platform.h"
 
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <functional>
 #include <limits>
 #include <mutex>
 #include <queue>
 
 #include "ObjectHeaderBase.h"
 #include "LogContainer.h"
+#include "Metrics.h"
 
 #include "vector_blf_export.h"
 
@@ -35,6 +39,47 @@ class VECTOR_BLF_EXPORT ObjectQueue final {
      */
     T * read();
 
+    /**
+     * Get access to front of queue, waiting at most until deadline.
+     *
+     * @param[in] deadline latest time to return
+     * @return object (or nullptr if empty). On timeout, good() is true.
+     */
+    T * read(const std::chrono::steady_clock::time_point & deadline);
+
+    /**
+     * Get several objects from front of queue.
+     *
+     * Waits until an object is available, and then dequeues up to count
+     * objects at once.
+     *
+     * @param[out] objs objects
+     * @param[in] count maximum number of objects
+     * @return number of objects (or 0 at eof)
+     */
+    std::size_t read(T ** objs, std::size_t count);
+
+    /**
+     * Get several objects from front of queue, without waiting.
+     *
+     * @param[out] objs objects
+     * @param[in] count maximum number of objects
+     * @return number of objects. If it's 0, eof() tells if the end is reached.
+     */
+    std::size_t tryRead(T ** objs, std::size_t count);
+
+    /**
+     * Call a function once, when objects or eof are available.
+     *
+     * The function is called by the thread, that writes the objects, sets
+     * the eof or aborts. Only one function can wait at a time.
+     *
+     * @param[in] function function
+     * @return false if objects or eof are already available. Then the
+     *   function is not called.
+     */
+    bool callWhenReadable(std::function<void()> function);
+
     /** @copydoc AbstractFile::tellg */
     uint32_t tellg() const;
 
@@ -47,6 +92,17 @@ class VECTOR_BLF_EXPORT ObjectQueue final {
      */
     void write(T * obj);
 
+    /**
+     * Enqueue several objects to end of queue.
+     *
+     * The objects are enqueued at once, as soon as the queue is not full.
+     * So the queue can exceed the buffer size by up to count objects.
+     *
+     * @param[in] objs objects
+     * @param[in] count number of objects
+     */
+    void write(T * const * objs, std::size_t count);
+
     /** @copydoc AbstractFile::tellp */
     uint32_t tellp() const;
 
@@ -56,7 +112,12 @@ class VECTOR_BLF_EXPORT ObjectQueue final {
     /** @copydoc AbstractFile::eof */
     bool eof() const;
 
-    /** @copydoc UncompressedFile::abort */
+    /**
+     * Abort further operations.
+     *
+     * Blocked threads are woken up. Objects, that are still queued, are
+     * not read anymore, but deleted with the queue.
+     */
     void abort();
 
     /** @copydoc UncompressedFile::setFileSize */
@@ -65,6 +126,9 @@ class VECTOR_BLF_EXPORT ObjectQueue final {
     /** @copydoc UncompressedFile::setBufferSize */
     void setBufferSize(uint32_t bufferSize);
 
+    /** @copydoc UncompressedFile::metrics */
+    QueueMetrics metrics() const;
+
     /** data was dequeued */
     std::condition_variable tellgChanged;
 
@@ -95,6 +159,33 @@ class VECTOR_BLF_EXPORT ObjectQueue final {
 
     /** mutex */
     mutable std::mutex m_mutex {};
+
+    /** metrics, collected with OPTION_USE_METRICS */
+    QueueMetrics m_metrics {};
+
+    /** function to call, when objects or eof are available */
+    std::function<void()> m_whenReadable {};
+
+    /**
+     * objects or eof available?
+     *
+     * @return true if read wouldn't wait
+     */
+    bool readable() const;
+
+    /**
+     * Call the function waiting for objects, after unlocking.
+     *
+     * @param[in] lock locked mutex
+     */
+    void notifyReadable(std::unique_lock<std::mutex> & lock);
+
+    /**
+     * Dequeue front of queue, after data or eof is available.
+     *
+     * @return object (or nullptr at eof)
+     */
+    T * dequeue();
 };
 
 /* explicit template instantiation */
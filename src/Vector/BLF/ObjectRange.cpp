@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ObjectRange.h"
+
+#include "File.h"
+
+namespace Vector {
+namespace BLF {
+
+ObjectBatch::ObjectBatch(File & file, std::size_t batchSize) :
+    m_file(file),
+    m_objects(batchSize > 0 ? batchSize : 1),
+    m_position(m_objects.size()) {
+}
+
+ObjectBatch::~ObjectBatch() {
+    /* delete the objects, that were not passed on */
+    for (; m_position < m_objects.size(); ++m_position)
+        delete m_objects[m_position];
+}
+
+ObjectHeaderBase * ObjectBatch::next() {
+    /* read next batch */
+    if (m_position >= m_objects.size()) {
+        m_objects.resize(m_objects.capacity());
+        m_objects.resize(m_file.read(m_objects.data(), m_objects.size()));
+        m_position = 0;
+        if (m_objects.empty())
+            return nullptr;
+    }
+
+    return m_objects[m_position++];
+}
+
+}
+}
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ObjectDispatch.h"
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+class File;
+
+/**
+ * Reads objects from a File in batches.
+ *
+ * All objects, that are available in the read queue, are taken at once, so
+ * the consumer only waits for the queue, when the batch is used up. In the
+ * meantime, the File threads decode the next batch.
+ */
+class VECTOR_BLF_EXPORT ObjectBatch final {
+  public:
+    /**
+     * Constructor
+     *
+     * @param[in] file file opened for reading
+     * @param[in] batchSize maximum number of objects per batch
+     */
+    ObjectBatch(File & file, std::size_t batchSize);
+    virtual ~ObjectBatch();
+
+    ObjectBatch(const ObjectBatch &) = delete;
+    ObjectBatch & operator=(const ObjectBatch &) = delete;
+
+    /**
+     * Get next object.
+     *
+     * @return object or nullptr at eof (ownership is passed)
+     */
+    virtual ObjectHeaderBase * next();
+
+  private:
+    /** file */
+    File & m_file;
+
+    /** objects of the current batch */
+    std::vector<ObjectHeaderBase *> m_objects {};
+
+    /** position of the next object in the current batch */
+    std::size_t m_position {};
+};
+
+template <typename T>
+class ObjectRange;
+
+/**
+ * Input iterator over the objects of an ObjectRange.
+ *
+ * Dereferencing gives the current object. It can be moved out to keep it,
+ * otherwise it's deleted when the iterator is incremented.
+ *
+ * @tparam T object class
+ */
+template <typename T>
+class ObjectIterator final {
+  public:
+    /** iterator category */
+    using iterator_category = std::input_iterator_tag;
+
+    /** value type */
+    using value_type = std::unique_ptr<T>;
+
+    /** difference type */
+    using difference_type = std::ptrdiff_t;
+
+    /** pointer */
+    using pointer = value_type *;
+
+    /** reference */
+    using reference = value_type &;
+
+    /** end iterator */
+    ObjectIterator() = default;
+
+    /**
+     * Iterator at the current object of a range.
+     *
+     * @param[in] range range
+     */
+    explicit ObjectIterator(ObjectRange<T> * range) :
+        m_range(range) {
+    }
+
+    /** @return current object */
+    reference operator*() const {
+        return m_range->m_current;
+    }
+
+    /** @return current object */
+    pointer operator->() const {
+        return &m_range->m_current;
+    }
+
+    /** @return iterator at the next object */
+    ObjectIterator & operator++() {
+        if (!m_range->advance())
+            m_range = nullptr;
+        return *this;
+    }
+
+    /** go to next object */
+    void operator++(int) {
+        ++*this;
+    }
+
+    /** @return true if both are at the same range, or both at the end */
+    bool operator==(const ObjectIterator & other) const {
+        return m_range == other.m_range;
+    }
+
+    /** @return false if both are at the same range, or both at the end */
+    bool operator!=(const ObjectIterator & other) const {
+        return m_range != other.m_range;
+    }
+
+  private:
+    /** range or nullptr at the end */
+    ObjectRange<T> * m_range {nullptr};
+};
+
+/**
+ * Range over the objects of a File, that are instances of T.
+ *
+ * Other objects are deleted without passing them on. The range can only be
+ * iterated once, as the objects are read from the File.
+ *
+ * @tparam T object class, e.g. ObjectHeaderBase for all objects
+ */
+template <typename T>
+class ObjectRange final {
+  public:
+    /**
+     * Constructor
+     *
+     * @param[in] file file opened for reading
+     * @param[in] batchSize maximum number of objects per batch
+     */
+    ObjectRange(File & file, std::size_t batchSize) :
+        m_batch(new ObjectBatch(file, batchSize)) {
+    }
+
+    /** @return iterator at the first object */
+    ObjectIterator<T> begin() {
+        if (!m_started) {
+            m_started = true;
+            advance();
+        }
+        return m_current ? ObjectIterator<T>(this) : ObjectIterator<T>();
+    }
+
+    /** @return end iterator */
+    ObjectIterator<T> end() {
+        return ObjectIterator<T>();
+    }
+
+  private:
+    friend class ObjectIterator<T>;
+
+    /** batch reader */
+    std::unique_ptr<ObjectBatch> m_batch;
+
+    /** current object */
+    std::unique_ptr<T> m_current {};
+
+    /** begin was called */
+    bool m_started {false};
+
+    /**
+     * Go to next object of class T.
+     *
+     * @return false at eof
+     */
+    bool advance() {
+        for (;;) {
+            std::unique_ptr<ObjectHeaderBase> ohb(m_batch->next());
+            if (!ohb) {
+                m_current.reset();
+                return false;
+            }
+            if (std::is_same<T, ObjectHeaderBase>::value || isInstanceOf<T>(ohb->objectType)) {
+                m_current.reset(static_cast<T *>(ohb.release()));
+                return true;
+            }
+        }
+    }
+};
+
+}
+}
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ObjectStatistics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "CompressedFile.h"
+#include "Exceptions.h"
+#include "LogContainer.h"
+#include "ObjectHeader.h"
+
+namespace Vector {
+namespace BLF {
+
+/** offset of objectFlags in ObjectHeader, ObjectHeader2 and VarObjectHeader */
+static const std::size_t objectFlagsOffset = 16;
+
+/** offset of objectTimeStamp in ObjectHeader, ObjectHeader2 and VarObjectHeader */
+static const std::size_t objectTimeStampOffset = 24;
+
+/**
+ * Copy a value from a buffer.
+ *
+ * @param[in] data buffer
+ * @return value
+ */
+template <typename T>
+static T get(const uint8_t * data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+bool ObjectStatistics::hasChannel(const ObjectType objectType) {
+    return channelSize(objectType) > 0;
+}
+
+std::size_t ObjectStatistics::channelSize(const ObjectType objectType) {
+    switch (objectType) {
+    case ObjectType::CAN_MESSAGE:
+    case ObjectType::CAN_ERROR:
+    case ObjectType::CAN_OVERLOAD:
+    case ObjectType::CAN_STATISTIC:
+    case ObjectType::CAN_DRIVER_ERROR:
+    case ObjectType::CAN_DRIVER_SYNC:
+    case ObjectType::CAN_ERROR_EXT:
+    case ObjectType::CAN_DRIVER_ERROR_EXT:
+    case ObjectType::CAN_MESSAGE2:
+    case ObjectType::CAN_FD_MESSAGE:
+    case ObjectType::CAN_SETTING_CHANGED:
+        return sizeof(uint16_t);
+
+    case ObjectType::CAN_FD_MESSAGE_64:
+    case ObjectType::CAN_FD_ERROR_64:
+        return sizeof(uint8_t);
+
+    default:
+        return 0;
+    }
+}
+
+void ObjectStatistics::scan(const std::string & filename) {
+    /* reset */
+    *this = ObjectStatistics();
+
+    /* open file */
+    CompressedFile compressedFile;
+    compressedFile.open(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!compressedFile.is_open())
+        throw Exception("ObjectStatistics::scan(): Unable to open file.");
+    fileStatistics.read(compressedFile);
+
+    const std::size_t headerSize = ObjectHeaderBase(0, ObjectType::UNKNOWN).calculateHeaderSize();
+    const std::size_t objectHeaderSize = ObjectHeader(ObjectType::UNKNOWN).calculateHeaderSize();
+    std::vector<uint8_t> buffer; // uncompressed data not yet processed
+    std::size_t offset = 0; // position of the next object in buffer, maybe before padding
+    uint64_t skip = 0; // remaining bytes of an object, that exceeds buffer
+    bool endOfData = false;
+    bool hasTimeStamp = false;
+    while (!endOfData) {
+        /* read header to identify type */
+        ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+        ohb.read(compressedFile);
+        if (!compressedFile.good() || (ohb.objectType != ObjectType::LOG_CONTAINER))
+            break;
+        compressedFile.seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
+
+        /* read and uncompress LogContainer */
+        LogContainer logContainer;
+        logContainer.read(compressedFile);
+        if (!compressedFile.good())
+            break;
+        logContainer.uncompress();
+        logContainerCount++;
+        compressedSize += logContainer.objectSize;
+        uncompressedSize += logContainer.uncompressedFileSize;
+
+        /* skip the remaining bytes of an object */
+        std::vector<uint8_t> & data = logContainer.uncompressedFile;
+        if (skip >= data.size()) {
+            skip -= data.size();
+            continue;
+        }
+
+        /* append to buffer */
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+        buffer.insert(buffer.end(), data.begin() + static_cast<std::ptrdiff_t>(skip), data.end());
+        offset = 0;
+        skip = 0;
+
+        /* walk over object headers */
+        for (;;) {
+            /* the next object starts after up to 3 bytes of padding */
+            bool available = true;
+            bool found = false;
+            for (std::size_t padding = 0; padding < 4; ++padding) {
+                if (offset + padding + headerSize > buffer.size()) {
+                    available = false;
+                    break;
+                }
+                if (get<uint32_t>(&buffer[offset + padding]) == ObjectSignature) {
+                    offset += padding;
+                    found = true;
+                    break;
+                }
+            }
+            if (!available)
+                break;
+            if (!found) {
+                /* no further objects, e.g. zero fill */
+                endOfData = true;
+                break;
+            }
+
+            /* object header */
+            const uint8_t * object = &buffer[offset];
+            uint16_t objectHeaderSizeInFile = get<uint16_t>(object + 4);
+            uint32_t size = get<uint32_t>(object + 8);
+            ObjectType objectType = get<ObjectType>(object + 12);
+            if (size < headerSize) {
+                endOfData = true;
+                break;
+            }
+
+            /* wait for the fields, that are needed */
+            bool timeStamp =
+                (objectHeaderSizeInFile >= objectHeaderSize) &&
+                (size >= objectHeaderSize) &&
+                (objectType != ObjectType::Unknown115);
+            std::size_t channelSize = ObjectStatistics::channelSize(objectType);
+            bool channel =
+                (channelSize > 0) &&
+                (size >= objectHeaderSizeInFile + channelSize);
+            std::size_t needed = headerSize;
+            if (timeStamp)
+                needed = objectHeaderSize;
+            if (channel)
+                needed = std::max<std::size_t>(needed, objectHeaderSizeInFile + channelSize);
+            if (offset + needed > buffer.size())
+                break;
+
+            /* statistics */
+            objectTypeCount[objectType]++;
+            if (objectType != ObjectType::Unknown115)
+                objectCount++;
+            objectSize += size;
+            if (channel) {
+                if (channelSize == sizeof(uint8_t))
+                    channelCount[get<uint8_t>(object + objectHeaderSizeInFile)]++;
+                else
+                    channelCount[get<uint16_t>(object + objectHeaderSizeInFile)]++;
+            }
+            if (timeStamp) {
+                uint64_t objectTimeStamp = get<uint64_t>(object + objectTimeStampOffset);
+                if (get<uint32_t>(object + objectFlagsOffset) & ObjectHeader::ObjectFlags::TimeTenMics)
+                    objectTimeStamp *= 10000;
+                if (!hasTimeStamp || (objectTimeStamp < firstObjectTimeStamp))
+                    firstObjectTimeStamp = objectTimeStamp;
+                if (!hasTimeStamp || (objectTimeStamp > lastObjectTimeStamp))
+                    lastObjectTimeStamp = objectTimeStamp;
+                hasTimeStamp = true;
+            }
+
+            /* next object */
+            if (offset + size <= buffer.size()) {
+                offset += size;
+            } else {
+                skip = offset + size - buffer.size();
+                offset = buffer.size();
+            }
+        }
+    }
+
+    compressedFile.close();
+}
+
+}
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "FileStatistics.h"
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Object statistics of a file, collected from the object headers only.
+ *
+ * scan() inflates the LogContainers, but doesn't create or read objects.
+ * It only looks at the object header, and the channel field of bus objects.
+ * This is several times faster than reading all objects with File::read.
+ */
+struct VECTOR_BLF_EXPORT ObjectStatistics final {
+    /**
+     * Collect statistics of a file.
+     *
+     * Previous values are reset.
+     *
+     * @param[in] filename file name
+     */
+    virtual void scan(const std::string & filename);
+
+    /**
+     * Check if the object has a channel directly after the object header.
+     *
+     * @param[in] objectType object type
+     * @return true if the object has a channel
+     */
+    static bool hasChannel(const ObjectType objectType);
+
+    /**
+     * Get the size of the channel directly after the object header.
+     *
+     * @param[in] objectType object type
+     * @return channel size in bytes, or 0 if the object has no channel
+     */
+    static std::size_t channelSize(const ObjectType objectType);
+
+    /** file statistics from file header */
+    FileStatistics fileStatistics {};
+
+    /** number of objects per object type */
+    std::map<ObjectType, uint64_t> objectTypeCount {};
+
+    /** number of objects per channel, only objects with hasChannel */
+    std::map<uint16_t, uint64_t> channelCount {};
+
+    /**
+     * number of objects
+     *
+     * Unknown115 is not counted, same as in FileStatistics::objectCount.
+     */
+    uint64_t objectCount {};
+
+    /** sum of objectSize of all objects */
+    uint64_t objectSize {};
+
+    /** number of LogContainers */
+    uint64_t logContainerCount {};
+
+    /** compressed size of all LogContainers, including their headers */
+    uint64_t compressedSize {};
+
+    /** uncompressed size of all LogContainers */
+    uint64_t uncompressedSize {};
+
+    /** earliest object timestamp in nanoseconds */
+    uint64_t firstObjectTimeStamp {};
+
+    /** latest object timestamp in nanoseconds */
+    uint64_t lastObjectTimeStamp {};
+};
+
+}
+}
@@ -0,0 +1,414 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ParallelFileReader.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "CompressedFile.h"
+#include "Exceptions.h"
+#include "File.h"
+#include "LogContainer.h"
+#include "UncompressedFile.h"
+
+namespace Vector {
+namespace BLF {
+
+/** LogContainer with its uncompressed position */
+struct Chunk {
+    /** uncompressed position */
+    uint64_t position;
+
+    /** LogContainer */
+    std::shared_ptr<LogContainer> logContainer;
+};
+
+/** LogContainers that are inflated and decoded by one thread */
+struct Partition {
+    /** LogContainers */
+    std::vector<Chunk> chunks {};
+
+    /** uncompressed position of the first LogContainer */
+    uint64_t begin {};
+
+    /** uncompressed position after the last LogContainer */
+    uint64_t end {};
+
+    /** uncompressed positions of the objects starting in this partition */
+    std::vector<uint64_t> objects {};
+
+    /** bytes of the successors, that complete the last object */
+    std::vector<char> tail {};
+};
+
+/** uncompressed data of all partitions of a round */
+class Round {
+  public:
+    /**
+     * @param[in] partitions partitions
+     */
+    explicit Round(const std::vector<Partition> & partitions) {
+        for (const Partition & partition : partitions) {
+            for (const Chunk & chunk : partition.chunks) {
+                m_positions.push_back(chunk.position);
+                m_logContainers.push_back(chunk.logContainer.get());
+            }
+        }
+        m_end = partitions.empty() ? 0 : partitions.back().end;
+    }
+
+    /**
+     * Copy uncompressed data.
+     *
+     * @param[in] position uncompressed position
+     * @param[out] s destination
+     * @param[in] n number of bytes
+     * @return false if the data is not (completely) in this round
+     */
+    bool read(uint64_t position, char * s, uint64_t n) const {
+        if (m_positions.empty() || (position < m_positions.front()) || (position + n > m_end))
+            return false;
+
+        /* find LogContainer containing position */
+        std::size_t i = static_cast<std::size_t>(std::upper_bound(m_positions.cbegin(), m_positions.cend(), position) - m_positions.cbegin()) - 1;
+        while (n > 0) {
+            uint64_t offset = position - m_positions[i];
+            uint64_t size = std::min<uint64_t>(n, m_logContainers[i]->uncompressedFileSize - offset);
+            std::memcpy(s, m_logContainers[i]->uncompressedFile.data() + offset, size);
+            s += size;
+            position += size;
+            n -= size;
+            ++i;
+        }
+        return true;
+    }
+
+  private:
+    /** uncompressed positions of the LogContainers */
+    std::vector<uint64_t> m_positions {};
+
+    /** LogContainers */
+    std::vector<const LogContainer *> m_logContainers {};
+
+    /** uncompressed position after the last LogContainer */
+    uint64_t m_end {};
+};
+
+/** fixed set of threads, that process the partitions of each round */
+class WorkerPool final {
+  public:
+    /**
+     * @param[in] workers number of threads
+     */
+    explicit WorkerPool(unsigned int workers) :
+        m_exceptions(workers) {
+        for (unsigned int worker = 0; worker < workers; ++worker)
+            m_threads.push_back(std::thread(workerThread, this, worker));
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_taskChanged.notify_all();
+        for (std::thread & thread : m_threads)
+            thread.join();
+    }
+
+    /**
+     * Run a function for each partition in its own thread, and wait for all.
+     *
+     * @param[in] count number of partitions, at most the number of threads
+     * @param[in] function function taking partition index
+     */
+    void run(std::size_t count, const std::function<void(std::size_t)> & function) {
+        /* hand over task */
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_function = &function;
+        m_count = count;
+        m_pending = m_threads.size();
+        m_generation++;
+        m_taskChanged.notify_all();
+
+        /* wait for all threads */
+        m_taskDone.wait(lock, [this] {
+            return m_pending == 0;
+        });
+        m_function = nullptr;
+
+        /* forward exceptions */
+        std::exception_ptr exception;
+        for (std::exception_ptr & workerException : m_exceptions) {
+            if (workerException && !exception)
+                exception = workerException;
+            workerException = nullptr;
+        }
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+  private:
+    /** threads */
+    std::vector<std::thread> m_threads {};
+
+    /** exceptions per thread */
+    std::vector<std::exception_ptr> m_exceptions;
+
+    /** mutex for the task */
+    std::mutex m_mutex {};
+
+    /** new task or stop */
+    std::condition_variable m_taskChanged {};
+
+    /** all threads done */
+    std::condition_variable m_taskDone {};
+
+    /** function of the task */
+    const std::function<void(std::size_t)> * m_function {nullptr};
+
+    /** number of partitions of the task */
+    std::size_t m_count {};
+
+    /** number of threads, that didn't finish the task yet */
+    std::size_t m_pending {};
+
+    /** task counter */
+    uint64_t m_generation {};
+
+    /** threads still running */
+    bool m_running {true};
+
+    /**
+     * Process the partition of the thread in each task.
+     *
+     * @param[in] workerPool worker pool
+     * @param[in] worker thread index
+     */
+    static void workerThread(WorkerPool * workerPool, std::size_t worker) {
+        uint64_t generation = 0;
+        std::unique_lock<std::mutex> lock(workerPool->m_mutex);
+        for (;;) {
+            /* wait for task */
+            workerPool->m_taskChanged.wait(lock, [workerPool, &generation] {
+                return !workerPool->m_running || (workerPool->m_generation != generation);
+            });
+            if (!workerPool->m_running)
+                return;
+            generation = workerPool->m_generation;
+
+            /* process partition without holding the lock */
+            const std::function<void(std::size_t)> * function = workerPool->m_function;
+            bool process = (worker < workerPool->m_count);
+            lock.unlock();
+            if (process) {
+                try {
+                    (*function)(worker);
+                } catch (...) {
+                    workerPool->m_exceptions[worker] = std::current_exception();
+                }
+            }
+            lock.lock();
+
+            /* task done */
+            if (--workerPool->m_pending == 0)
+                workerPool->m_taskDone.notify_all();
+        }
+    }
+};
+
+unsigned int ParallelFileReader::workerCount() const {
+    if (threadCount > 0)
+        return threadCount;
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+void ParallelFileReader::forEach(const std::string & filename, const std::function<void(unsigned int worker, const ObjectHeaderBase & ohb)> & function) {
+    /* open file */
+    CompressedFile compressedFile;
+    compressedFile.open(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!compressedFile.is_open())
+        throw Exception("ParallelFileReader::forEach(): Unable to open file.");
+    fileStatistics.read(compressedFile);
+
+    const unsigned int workers = workerCount();
+    WorkerPool workerPool(workers);
+    const uint16_t headerSize = ObjectHeaderBase(0, ObjectType::UNKNOWN).calculateHeaderSize();
+    uint64_t uncompressedPosition = 0; // after the last read LogContainer
+    uint64_t nextObject = 0; // position of the next object, maybe before padding
+    std::vector<Chunk> carry; // LogContainers with the next object
+    bool endOfFile = false;
+    while (!endOfFile || !carry.empty()) {
+        /* read partitions */
+        std::vector<Partition> partitions;
+        while (!endOfFile && (partitions.size() < workers)) {
+            Partition partition;
+            partition.begin = uncompressedPosition;
+            partition.end = uncompressedPosition;
+            bool carried = false;
+            if (partitions.empty() && !carry.empty()) {
+                /* continue with the unfinished object of the last round */
+                partition.chunks.swap(carry);
+                partition.begin = partition.chunks.front().position;
+                carried = true;
+            }
+
+            /* the carried LogContainers don't complete the object, so read at least one more */
+            while (carried || (partition.end - std::max(partition.begin, nextObject) < partitionSize)) {
+                carried = false;
+
+                /* read header to identify type */
+                ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+                ohb.read(compressedFile);
+                if (!compressedFile.good() || (ohb.objectType != ObjectType::LOG_CONTAINER)) {
+                    endOfFile = true;
+                    break;
+                }
+                compressedFile.seekg(-ohb.calculateHeaderSize(), std::ios_base::cur);
+
+                /* read LogContainer */
+                std::shared_ptr<LogContainer> logContainer(new LogContainer);
+                logContainer->read(compressedFile);
+                if (!compressedFile.good()) {
+                    endOfFile = true;
+                    break;
+                }
+                Chunk chunk;
+                chunk.position = uncompressedPosition;
+                chunk.logContainer = logContainer;
+                partition.chunks.push_back(chunk);
+                uncompressedPosition += logContainer->uncompressedFileSize;
+                partition.end = uncompressedPosition;
+            }
+            if (!partition.chunks.empty())
+                partitions.push_back(std::move(partition));
+        }
+        carry.clear();
+        if (partitions.empty())
+            break;
+
+        /* inflate, the carried LogContainers are already inflated */
+        workerPool.run(partitions.size(), [&partitions](std::size_t i) {
+            for (Chunk & chunk : partitions[i].chunks)
+                if (chunk.logContainer->uncompressedFile.empty())
+                    chunk.logContainer->uncompress();
+        });
+
+        /* hop over the object headers to find the object starts */
+        Round round(partitions);
+        std::size_t k = 0;
+        bool endOfData = false;
+        for (;;) {
+            /* the next object starts after up to 3 bytes of padding */
+            ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+            char header[16];
+            bool available = true;
+            bool found = false;
+            for (uint64_t padding = 0; padding < 4; ++padding) {
+                if (!round.read(nextObject + padding, header, headerSize)) {
+                    available = false;
+                    break;
+                }
+                std::memcpy(&ohb.signature, header, sizeof(ohb.signature));
+                if (ohb.signature == ObjectSignature) {
+                    nextObject += padding;
+                    found = true;
+                    break;
+                }
+            }
+            if (!available)
+                break;
+            if (!found) {
+                /* no further objects, e.g. zero fill */
+                endOfData = true;
+                break;
+            }
+            std::memcpy(&ohb.objectSize, header + 8, sizeof(ohb.objectSize));
+            if (ohb.objectSize < headerSize) {
+                endOfData = true;
+                break;
+            }
+
+            /* object needs to be completely in this round */
+            if (nextObject + ohb.objectSize > partitions.back().end)
+                break;
+
+            /* assign object to partition */
+            while (nextObject >= partitions[k].end)
+                ++k;
+            partitions[k].objects.push_back(nextObject);
+            nextObject += ohb.objectSize;
+        }
+
+        /* complete the last object of each partition */
+        for (Partition & partition : partitions) {
+            if (partition.objects.empty())
+                continue;
+            uint64_t lastObject = partition.objects.back();
+            uint32_t objectSize;
+            round.read(lastObject + 8, reinterpret_cast<char *>(&objectSize), sizeof(objectSize));
+            if (lastObject + objectSize > partition.end) {
+                partition.tail.resize(lastObject + objectSize - partition.end);
+                round.read(partition.end, partition.tail.data(), partition.tail.size());
+            }
+        }
+
+        /* carry LogContainers with an unfinished object to the next round, it may start in any partition */
+        if (!endOfData) {
+            for (const Partition & partition : partitions)
+                for (const Chunk & chunk : partition.chunks)
+                    if (chunk.position + chunk.logContainer->uncompressedFileSize > nextObject)
+                        carry.push_back(chunk);
+        } else {
+            endOfFile = true;
+        }
+
+        /* decode */
+        workerPool.run(partitions.size(), [&partitions, &function](std::size_t i) {
+            Partition & partition = partitions[i];
+            if (partition.objects.empty())
+                return;
+
+            /* stitch LogContainers and tail together */
+            UncompressedFile uncompressedFile;
+            for (Chunk & chunk : partition.chunks)
+                uncompressedFile.write(chunk.logContainer);
+            if (!partition.tail.empty()) {
+                uncompressedFile.setDefaultLogContainerSize(static_cast<uint32_t>(partition.tail.size()));
+                uncompressedFile.write(partition.tail.data(), static_cast<std::streamsize>(partition.tail.size()));
+            }
+            uncompressedFile.setFileSize(uncompressedFile.tellp());
+
+            /* decode objects */
+            for (uint64_t object : partition.objects) {
+                std::streamoff offset = static_cast<std::streamoff>(object - partition.begin);
+                uncompressedFile.clear();
+                uncompressedFile.seekg(offset, std::ios_base::beg);
+                ObjectHeaderBase ohb(0, ObjectType::UNKNOWN);
+                ohb.read(uncompressedFile);
+                uncompressedFile.seekg(offset, std::ios_base::beg);
+
+                /* unknown object types and restore point containers are skipped */
+                if (ohb.objectType == ObjectType::Unknown115)
+                    continue;
+                std::unique_ptr<ObjectHeaderBase> obj(File::createObject(ohb.objectType));
+                if (!obj)
+                    continue;
+                obj->read(uncompressedFile);
+                function(static_cast<unsigned int>(i), *obj);
+            }
+        });
+    }
+
+    compressedFile.close();
+}
+
+}
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "FileStatistics.h"
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Reads the objects of one file in parallel, for aggregations that don't
+ * depend on the object order.
+ *
+ * The file is split into partitions along LogContainer boundaries. The
+ * partitions are inflated in parallel. A cheap sequential pass over the
+ * object headers then finds the first object in each partition. Finally the
+ * partitions are decoded in parallel. An object that straddles two
+ * partitions is decoded by the partition it starts in, which gets the
+ * missing bytes from its successors. This is done in rounds of one
+ * partition per thread, by a fixed set of threads, so memory usage is
+ * bounded by threadCount * partitionSize. Only an object, that doesn't
+ * fit into a round, is carried into the next round, together with the
+ * LogContainers it starts in.
+ *
+ * Each thread has its own accumulator, so no locking is needed in the
+ * accumulation. The accumulators are reduced at the end.
+ */
+class VECTOR_BLF_EXPORT ParallelFileReader final {
+  public:
+    ParallelFileReader() = default;
+    virtual ~ParallelFileReader() = default;
+
+    /**
+     * Number of threads.
+     *
+     * Zero uses std::thread::hardware_concurrency.
+     */
+    unsigned int threadCount {0};
+
+    /**
+     * Minimum uncompressed size of a partition in bytes.
+     *
+     * Partitions consist of complete LogContainers.
+     */
+    uint32_t partitionSize {0x800000};
+
+    /**
+     * File statistics of the last processed file.
+     */
+    FileStatistics fileStatistics {};
+
+    /**
+     * Number of threads, that will be used.
+     *
+     * @return number of threads
+     */
+    virtual unsigned int workerCount() const;
+
+    /**
+     * Call a function for each object of a file.
+     *
+     * The function is called from workerCount() threads in parallel. Calls
+     * with the same worker index never overlap. The object is deleted after
+     * the call.
+     *
+     * Objects of unknown object type and RestorePointContainers are skipped.
+     *
+     * @param[in] filename file name
+     * @param[in] function function taking worker index and object
+     */
+    virtual void forEach(const std::string & filename, const std::function<void(unsigned int worker, const ObjectHeaderBase & ohb)> & function);
+
+    /**
+     * Aggregate all objects of a file.
+     *
+     * @param[in] filename file name
+     * @param[in] init initial value of each accumulator
+     * @param[in] map function(Accumulator &, const ObjectHeaderBase &) to accumulate an object
+     * @param[in] reduce function(Accumulator &, const Accumulator &) to merge two accumulators
+     * @return reduced accumulator
+     */
+    template <typename Accumulator, typename Map, typename Reduce>
+    Accumulator mapReduce(const std::string & filename, const Accumulator & init, Map map, Reduce reduce) {
+        /* map */
+        std::vector<Accumulator> accumulators(workerCount(), init);
+        forEach(filename, [&accumulators, &map](unsigned int worker, const ObjectHeaderBase & ohb) {
+            map(accumulators[worker], ohb);
+        });
+
+        /* reduce */
+        Accumulator result = accumulators[0];
+        for (std::size_t i = 1; i < accumulators.size(); ++i)
+            reduce(result, accumulators[i]);
+        return result;
+    }
+};
+
+}
+}
@@ -18,6 +18,9 @@ void RestorePointContainer::read(AbstractFile & is) {
     is.read(reinterpret_cast<char *>(&dataLength), sizeof(dataLength));
     data.resize(dataLength);
     is.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    /* skip padding */
+    is.seekg(objectSize % 4, std::ios_base::cur);
 }
 
 void RestorePointContainer::write(AbstractFile & os) {
@@ -28,6 +31,9 @@ void RestorePointContainer::write(AbstractFile & os) {
     os.write(reinterpret_cast<char *>(reservedRestorePointContainer.data()), static_cast<std::streamsize>(reservedRestorePointContainer.size()));
     os.write(reinterpret_cast<char *>(&dataLength), sizeof(dataLength));
     os.write(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    /* skip padding */
+    os.skipp(objectSize % 4);
 }
 
 uint32_t RestorePointContainer::calculateObjectSize() const {
@@ -13,7 +13,8 @@ void RestorePoints::read(AbstractFile & is) {
     is.read(reinterpret_cast<char *>(&objectSize), sizeof(objectSize));
     is.read(reinterpret_cast<char *>(&objectInterval), sizeof(objectInterval));
     restorePoints.resize((objectSize - calculateObjectSize()) / RestorePoint::calculateObjectSize()); // all remaining data
-    is.read(reinterpret_cast<char *>(restorePoints.data()), static_cast<std::streamsize>(restorePoints.size()) * RestorePoint::calculateObjectSize());
+    for (RestorePoint & restorePoint : restorePoints)
+        restorePoint.read(is);
 }
 
 void RestorePoints::write(AbstractFile & os) {
@@ -22,7 +23,8 @@ void RestorePoints::write(AbstractFile & os) {
 
     os.write(reinterpret_cast<char *>(&objectSize), sizeof(objectSize));
     os.write(reinterpret_cast<char *>(&objectInterval), sizeof(objectInterval));
-    os.write(reinterpret_cast<char *>(restorePoints.data()), static_cast<std::streamsize>(restorePoints.size()) * RestorePoint::calculateObjectSize());
+    for (RestorePoint & restorePoint : restorePoints)
+        restorePoint.write(os);
 }
 
 uint32_t RestorePoints::calculateObjectSize() const {
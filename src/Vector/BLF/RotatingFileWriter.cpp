@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "RotatingFileWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <zlib.h>
+
+#include "Exceptions.h"
+#include "ObjectDispatch.h"
+
+namespace Vector {
+namespace BLF {
+
+RotatingFileWriter::RotatingFileWriter() {
+    m_closeThreadRunning = true;
+    m_closeThread = std::thread(closeThread, this);
+}
+
+RotatingFileWriter::~RotatingFileWriter() {
+    try {
+        close();
+    } catch (const std::exception &) {
+        /* ignore exceptions of close thread in destructor */
+    }
+
+    /* finalize closeThread */
+    {
+        std::lock_guard<std::mutex> lock(m_closeQueueMutex);
+        m_closeThreadRunning = false;
+    }
+    m_closeQueueChanged.notify_all();
+    if (m_closeThread.joinable())
+        m_closeThread.join();
+}
+
+void RotatingFileWriter::open(const std::string & baseName) {
+    /* check */
+    if (is_open())
+        return;
+
+    /* same measurementStartTime in all files */
+    if (fileStatistics.measurementStartTime.year == 0)
+        fileStatistics.measurementStartTime = currentSystemTime();
+
+    m_baseName = baseName;
+    m_fileNames.clear();
+    openNextFile();
+}
+
+bool RotatingFileWriter::is_open() const {
+    return m_file && m_file->is_open();
+}
+
+void RotatingFileWriter::write(ObjectHeaderBase * ohb) {
+    /* check */
+    if (!is_open()) {
+        delete ohb;
+        throw Exception("RotatingFileWriter::write(): File is not open.");
+    }
+
+    /* serialized object size including padding */
+    uint64_t objectSize = ohb->calculateObjectSize();
+    objectSize += objectSize % 4;
+
+    /* rotate before the object, that exceeds the limit */
+    if (limitReached(*ohb, objectSize))
+        rotate();
+
+    /* statistics */
+    if (m_objectCount == 0)
+        m_firstTimeStamp = objectTimeStampNs(*ohb);
+    m_objectCount++;
+    m_uncompressedFileSize += objectSize;
+
+    /* write object */
+    m_file->write(ohb);
+}
+
+void RotatingFileWriter::rotate() {
+    /* check */
+    if (!is_open())
+        return;
+
+    /* hand over current file to closeThread */
+    {
+        std::lock_guard<std::mutex> lock(m_closeQueueMutex);
+        m_closeQueue.push_back(std::move(m_file));
+    }
+    m_closeQueueChanged.notify_all();
+
+    openNextFile();
+}
+
+void RotatingFileWriter::close() {
+    /* hand over current file to closeThread */
+    if (m_file) {
+        std::lock_guard<std::mutex> lock(m_closeQueueMutex);
+        m_closeQueue.push_back(std::move(m_file));
+    }
+    m_closeQueueChanged.notify_all();
+
+    /* wait until all files are closed */
+    std::unique_lock<std::mutex> lock(m_closeQueueMutex);
+    m_closeQueueChanged.wait(lock, [this] {
+        return m_closeQueue.empty();
+    });
+
+    /* forward exception of closeThread */
+    if (m_closeThreadException) {
+        std::exception_ptr closeThreadException = m_closeThreadException;
+        m_closeThreadException = nullptr;
+        std::rethrow_exception(closeThreadException);
+    }
+}
+
+std::vector<std::string> RotatingFileWriter::fileNames() const {
+    return m_fileNames;
+}
+
+void RotatingFileWriter::openNextFile() {
+    /* file name */
+    char index[16];
+    std::snprintf(index, sizeof(index), "_%04u.blf", static_cast<unsigned int>(m_fileNames.size()));
+    std::string fileName = m_baseName + index;
+
+    /* setup file */
+    std::unique_ptr<File> file(new File);
+    file->fileStatistics = fileStatistics;
+    file->compressionLevel = compressionLevel;
+    file->writeRestorePoints = writeRestorePoints;
+    file->checkpointInterval = checkpointInterval;
+    file->checkpointSize = checkpointSize;
+    file->setDefaultLogContainerSize(defaultLogContainerSize);
+
+    /* open file */
+    file->open(fileName, std::ios_base::out);
+    if (!file->is_open())
+        throw Exception("RotatingFileWriter::openNextFile(): Unable to open file.");
+    m_file = std::move(file);
+    m_fileNames.push_back(fileName);
+    m_objectCount = 0;
+    m_uncompressedFileSize = 0;
+    m_firstTimeStamp = 0;
+}
+
+bool RotatingFileWriter::limitReached(const ObjectHeaderBase & ohb, uint64_t objectSize) const {
+    /* never start an empty file */
+    if (m_objectCount == 0)
+        return false;
+
+    /* object count */
+    if ((maxObjectCount > 0) && (m_objectCount >= maxObjectCount))
+        return true;
+
+    /* compressed file size including the object */
+    if (maxFileSize > 0) {
+        uint64_t uncompressedFileSize = m_uncompressedFileSize + objectSize;
+
+        /* nothing compressed yet */
+        if (fileStatistics.statisticsSize + compressedSizeBound(uncompressedFileSize) > maxFileSize) {
+            /* compressed so far, the file size is taken afterwards, so it covers the compressed objects */
+            uint64_t compressedObjectsSize = m_file->waitForCompressedObjects(0);
+            uint64_t compressedFileSize = m_file->currentCompressedFileSize;
+            if (compressedFileSize + compressedSizeBound(uncompressedFileSize - compressedObjectsSize) > maxFileSize) {
+                /* close to the limit, so wait for the complete LogContainers */
+                compressedObjectsSize = m_file->waitForCompressedObjects(m_uncompressedFileSize - m_uncompressedFileSize % std::max<uint32_t>(defaultLogContainerSize, 1));
+                compressedFileSize = m_file->currentCompressedFileSize;
+                if (compressedFileSize + compressedSizeBound(uncompressedFileSize - compressedObjectsSize) > maxFileSize)
+                    return true;
+            }
+        }
+    }
+
+    /* measurement duration */
+    if (maxDuration.count() > 0) {
+        uint64_t timeStamp = objectTimeStampNs(ohb);
+        if ((timeStamp >= m_firstTimeStamp) &&
+                (timeStamp - m_firstTimeStamp >= static_cast<uint64_t>(maxDuration.count())))
+            return true;
+    }
+
+    return false;
+}
+
+uint64_t RotatingFileWriter::compressedSizeBound(uint64_t uncompressedFileSize) const {
+    /* LogContainer header and padding, and zlib overhead */
+    uint64_t logContainerSize = std::max<uint64_t>(defaultLogContainerSize, 1);
+    uint64_t logContainerOverhead = 32 + 3;
+    if (compressionLevel != 0)
+        logContainerOverhead += ::compressBound(static_cast<uLong>(logContainerSize)) - logContainerSize;
+
+    /* LogContainers are filled up to defaultLogContainerSize */
+    uint64_t logContainerCount = (uncompressedFileSize + logContainerSize - 1) / logContainerSize;
+
+    return
+        uncompressedFileSize +
+        logContainerCount * logContainerOverhead;
+}
+
+void RotatingFileWriter::closeThread(RotatingFileWriter * rotatingFileWriter) {
+    std::unique_lock<std::mutex> lock(rotatingFileWriter->m_closeQueueMutex);
+    for (;;) {
+        /* wait for files */
+        rotatingFileWriter->m_closeQueueChanged.wait(lock, [rotatingFileWriter] {
+            return !rotatingFileWriter->m_closeQueue.empty() || !rotatingFileWriter->m_closeThreadRunning;
+        });
+        if (rotatingFileWriter->m_closeQueue.empty())
+            return;
+
+        /* close file without holding the lock */
+        File * file = rotatingFileWriter->m_closeQueue.front().get();
+        lock.unlock();
+        try {
+            file->close();
+        } catch (...) {
+            lock.lock();
+            if (!rotatingFileWriter->m_closeThreadException)
+                rotatingFileWriter->m_closeThreadException = std::current_exception();
+            lock.unlock();
+        }
+        lock.lock();
+
+        /* file done */
+        rotatingFileWriter->m_closeQueue.pop_front();
+        rotatingFileWriter->m_closeQueueChanged.notify_all();
+    }
+}
+
+}
+}
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "platform.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "File.h"
+#include "FileStatistics.h"
+#include "ObjectHeaderBase.h"
+
+#include "vector_blf_export.h"
+
+namespace Vector {
+namespace BLF {
+
+/**
+ * Writes objects into a sequence of files, starting a new file when the
+ * current one reaches a size, object count or duration limit.
+ *
+ * The files are named <baseName>_<index>.blf, with a four digit index
+ * starting at 0. All files carry the same fileStatistics (application and
+ * measurementStartTime), so the object timestamps stay valid across files
+ * and no objects are lost between files.
+ *
+ * The previous file is closed on a background thread, so write() doesn't
+ * block on compressing the remaining data, writing the restore points and
+ * the final FileStatistics.
+ */
+class VECTOR_BLF_EXPORT RotatingFileWriter final {
+  public:
+    RotatingFileWriter();
+    virtual ~RotatingFileWriter();
+
+    /**
+     * File statistics used as template for each file.
+     *
+     * Set application and measurementStartTime before open. If
+     * measurementStartTime is not set, open sets it to the current time,
+     * so that all files share the same one.
+     */
+    FileStatistics fileStatistics {};
+
+    /**
+     * Maximum compressed file size in bytes.
+     *
+     * The limit is checked in write() against the size of the LogContainers
+     * already compressed, plus an upper bound for the objects still queued
+     * for compression. A file is rotated before the object, that would
+     * exceed the limit. Close to the limit, write() waits until the complete
+     * LogContainers are compressed, so that a file falls short of the limit
+     * by at most one LogContainer. The restore points written at close are
+     * not included.
+     *
+     * Zero disables size based rotation.
+     */
+    uint64_t maxFileSize {0};
+
+    /**
+     * Maximum number of objects per file.
+     *
+     * Zero disables object count based rotation.
+     */
+    uint32_t maxObjectCount {0};
+
+    /**
+     * Maximum measurement duration per file.
+     *
+     * This is the difference between the object timestamps of the first
+     * and the current object in the file.
+     *
+     * Zero disables duration based rotation.
+     */
+    std::chrono::nanoseconds maxDuration {0};
+
+    /** @copydoc File::compressionLevel */
+    int compressionLevel {1};
+
+    /** @copydoc File::writeRestorePoints */
+    bool writeRestorePoints {true};
+
+    /** @copydoc File::checkpointInterval */
+    std::chrono::milliseconds checkpointInterval {0};
+
+    /** @copydoc File::checkpointSize */
+    uint64_t checkpointSize {0};
+
+    /** @copydoc File::defaultLogContainerSize */
+    uint32_t defaultLogContainerSize {0x20000};
+
+    /**
+     * open first file
+     *
+     * @param[in] baseName file name without index and extension
+     */
+    virtual void open(const std::string & baseName);
+
+    /**
+     * is file open?
+     *
+     * @return true if file is open
+     */
+    virtual bool is_open() const;
+
+    /**
+     * Write object.
+     *
+     * Starts a new file before the object, if a limit is reached.
+     *
+     * @param[in] ohb write object (ownership is taken)
+     */
+    virtual void write(ObjectHeaderBase * ohb);
+
+    /**
+     * Start a new file now.
+     */
+    virtual void rotate();
+
+    /**
+     * close current file and wait until all files are closed
+     */
+    virtual void close();
+
+    /**
+     * Get names of all files written so far.
+     *
+     * @return file names
+     */
+    virtual std::vector<std::string> fileNames() const;
+
+  private:
+    /** file name without index and extension */
+    std::string m_baseName {};
+
+    /** names of all files */
+    std::vector<std::string> m_fileNames {};
+
+    /** current file */
+    std::unique_ptr<File> m_file {};
+
+    /** number of objects in current file */
+    uint32_t m_objectCount {};
+
+    /** serialized size of the objects in current file */
+    uint64_t m_uncompressedFileSize {};
+
+    /** timestamp of first object in current file */
+    uint64_t m_firstTimeStamp {};
+
+    /** files to be closed */
+    std::deque<std::unique_ptr<File>> m_closeQueue {};
+
+    /** mutex for m_closeQueue */
+    std::mutex m_closeQueueMutex {};
+
+    /** file was added to m_closeQueue */
+    std::condition_variable m_closeQueueChanged {};
+
+    /** close thread */
+    std::thread m_closeThread {};
+
+    /** close thread still running */
+    bool m_closeThreadRunning {};
+
+    /** exception in close thread */
+    std::exception_ptr m_closeThreadException {};
+
+    /** open next file */
+    void openNextFile();
+
+    /**
+     * Check if the object needs a new file.
+     *
+     * @param[in] ohb object
+     * @param[in] objectSize serialized object size
+     * @return true if a limit is reached
+     */
+    bool limitReached(const ObjectHeaderBase & ohb, uint64_t objectSize) const;
+
+    /**
+     * Upper bound of the compressed size of objects.
+     *
+     * @param[in] uncompressedFileSize serialized size of the objects
+     * @return compressed size including LogContainer headers
+     */
+    uint64_t compressedSizeBound(uint64_t uncompressedFileSize) const;
+
+    /**
+     * Close files from m_closeQueue.
+     *
+     * @param[in] rotatingFileWriter rotating file writer
+     */
+    static void closeThread(RotatingFileWriter * rotatingFileWriter);
+};
+
+}
+}
@@ -33,12 +33,12 @@ void UncompressedFile::read(char * s, std::streamsize n) {
     std::unique_lock<std::mutex> lock(m_mutex);
 
     /* wait until there is sufficient data */
-    tellpChanged.wait(lock, [&] {
+    timedWait(tellpChanged, lock, [&] {
         return
         m_abort ||
         (n + m_tellg <= m_tellp) ||
         (n + m_tellg > m_fileSize);
-    });
+    }, m_metrics.readWaitTime);
 
     /* handle read behind eof */
     if (n + m_tellg > m_fileSize) {
@@ -48,32 +48,7 @@ void UncompressedFile::read(char * s, std::streamsize n) {
         m_rdstate = std::ios_base::goodbit;
 
     /* read data */
-    m_gcount = 0;
-    while (n > 0) {
-        /* find starting log container */
-        std::shared_ptr<LogContainer> logContainer = logContainerContaining(m_tellg);
-        if (!logContainer)
-            break;
-
-        /* offset to read */
-        std::streamoff offset = m_tellg - logContainer->filePosition;
-
-        /* copy data */
-        std::streamsize gcount = std::min(n, static_cast<std::streamsize>(logContainer->uncompressedFileSize - offset));
-        std::copy(logContainer->uncompressedFile.cbegin() + offset, logContainer->uncompressedFile.cbegin() + offset + gcount, s);
-
-        /* remember get count */
-        m_gcount += gcount;
-
-        /* new get position */
-        m_tellg += gcount;
-
-        /* advance */
-        s += gcount;
-
-        /* calculate remaining data to copy */
-        n -= gcount;
-    }
+    copyData(s, n);
 
     /* notify */
     tellgChanged.notify_all();
@@ -89,12 +64,22 @@ std::streampos UncompressedFile::tellg() {
     return m_tellg;
 }
 
-void UncompressedFile::seekg(std::streamoff off, const std::ios_base::seekdir /*way*/) {
+void UncompressedFile::seekg(std::streamoff off, const std::ios_base::seekdir way) {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
     /* new get position */
-    m_tellg = std::min(static_cast<std::streamsize>(m_tellg + off), m_fileSize);
+    switch (way) {
+    case std::ios_base::beg:
+        m_tellg = std::min(static_cast<std::streamsize>(off), m_fileSize);
+        break;
+    case std::ios_base::end:
+        m_tellg = m_fileSize + off;
+        break;
+    default:
+        m_tellg = std::min(static_cast<std::streamsize>(m_tellg + off), m_fileSize);
+        break;
+    }
 
     /* notify */
     tellgChanged.notify_all();
@@ -105,11 +90,11 @@ void UncompressedFile::write(const char * s, std::streamsize n) {
     std::unique_lock<std::mutex> lock(m_mutex);
 
     /* wait for free space */
-    tellgChanged.wait(lock, [&] {
+    timedWait(tellgChanged, lock, [&] {
         return
         m_abort ||
         ((m_tellp - m_tellg) < m_bufferSize);
-    });
+    }, m_metrics.writeWaitTime);
 
     /* write data */
     while (n > 0) {
@@ -153,6 +138,12 @@ void UncompressedFile::write(const char * s, std::streamsize n) {
     if (m_tellp >= m_fileSize)
         m_fileSize = m_tellp;
 
+#ifdef VECTOR_BLF_USE_METRICS
+    /* fill level */
+    if (static_cast<uint64_t>(m_tellp - m_tellg) > m_metrics.highWaterMark)
+        m_metrics.highWaterMark = static_cast<uint64_t>(m_tellp - m_tellg);
+#endif
+
     /* notify */
     tellpChanged.notify_all();
 }
@@ -181,6 +172,14 @@ bool UncompressedFile::eof() const {
     return (m_rdstate & std::ios_base::eofbit);
 }
 
+void UncompressedFile::clear() {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* reset error state */
+    m_rdstate = std::ios_base::goodbit;
+}
+
 void UncompressedFile::abort() {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -198,11 +197,11 @@ void UncompressedFile::write(const std::shared_ptr<LogContainer> & logContainer)
     std::unique_lock<std::mutex> lock(m_mutex);
 
     /* wait for free space */
-    tellgChanged.wait(lock, [&] {
+    timedWait(tellgChanged, lock, [&] {
         return
         m_abort ||
-        static_cast<uint32_t>(m_tellp - m_tellg) < m_bufferSize;
-    });
+        ((m_tellp - m_tellg) < m_bufferSize);
+    }, m_metrics.writeWaitTime);
 
     /* append logContainer */
     m_data.push_back(logContainer);
@@ -217,10 +216,75 @@ void UncompressedFile::write(const std::shared_ptr<LogContainer> & logContainer)
     /* advance put pointer */
     m_tellp += logContainer->uncompressedFileSize;
 
+    /* if new position is behind eof, shift it */
+    if (m_tellp >= m_fileSize)
+        m_fileSize = m_tellp;
+
+#ifdef VECTOR_BLF_USE_METRICS
+    /* fill level */
+    if (static_cast<uint64_t>(m_tellp - m_tellg) > m_metrics.highWaterMark)
+        m_metrics.highWaterMark = static_cast<uint64_t>(m_tellp - m_tellg);
+#endif
+
     /* notify */
     tellpChanged.notify_all();
 }
 
+std::shared_ptr<LogContainer> UncompressedFile::readLogContainer() {
+    /* mutex lock */
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    /* wait until there is sufficient data or a complete log container */
+    std::streamsize n = m_defaultLogContainerSize;
+    std::shared_ptr<LogContainer> logContainer;
+    auto complete = [&]() -> bool {
+        logContainer = logContainerContaining(m_tellg);
+        return
+            logContainer &&
+            (logContainer->filePosition == m_tellg) &&
+            (logContainer->filePosition + static_cast<std::streamoff>(logContainer->uncompressedFileSize) <= m_tellp);
+    };
+    timedWait(tellpChanged, lock, [&] {
+        return
+        m_abort ||
+        (n + m_tellg <= m_tellp) ||
+        (n + m_tellg > m_fileSize) ||
+        complete();
+    }, m_metrics.readWaitTime);
+
+    /* hand over complete log container */
+    if (complete() &&
+            (m_tellg + static_cast<std::streamoff>(logContainer->uncompressedFileSize) <= m_fileSize)) {
+        m_gcount = logContainer->uncompressedFileSize;
+        m_tellg += m_gcount;
+
+        /* a smaller log container at the end is the last one */
+        if ((m_gcount < n) && (m_tellg >= m_fileSize))
+            m_rdstate = std::ios_base::eofbit | std::ios_base::failbit;
+        else
+            m_rdstate = std::ios_base::goodbit;
+    } else {
+        /* handle read behind eof */
+        if (n + m_tellg > m_fileSize) {
+            n = m_fileSize - m_tellg;
+            m_rdstate = std::ios_base::eofbit | std::ios_base::failbit;
+        } else
+            m_rdstate = std::ios_base::goodbit;
+
+        /* copy data into new log container */
+        logContainer = std::make_shared<LogContainer>();
+        logContainer->uncompressedFile.resize(static_cast<std::size_t>(std::max<std::streamsize>(n, 0)));
+        copyData(reinterpret_cast<char *>(logContainer->uncompressedFile.data()), n);
+        logContainer->uncompressedFile.resize(static_cast<std::size_t>(m_gcount));
+        logContainer->uncompressedFileSize = static_cast<uint32_t>(m_gcount);
+    }
+
+    /* notify */
+    tellgChanged.notify_all();
+
+    return logContainer;
+}
+
 void UncompressedFile::nextLogContainer() {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -258,12 +322,24 @@ void UncompressedFile::setFileSize(std::streamsize fileSize) {
     tellpChanged.notify_all();
 }
 
-void UncompressedFile::setBufferSize(std::streamsize bufferSize) {
+std::streamsize UncompressedFile::bufferSize() const {
     /* mutex lock */
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    /* return max size */
+    return m_bufferSize;
+}
+
+void UncompressedFile::setBufferSize(std::streamsize bufferSize) {
+    /* mutex lock */
+    std::unique_lock<std::mutex> lock(m_mutex);
+
     /* set max size */
     m_bufferSize = bufferSize;
+
+    /* wake up writers, that wait for free space */
+    lock.unlock();
+    tellgChanged.notify_all();
 }
 
 void UncompressedFile::dropOldData() {
@@ -302,6 +378,42 @@ void UncompressedFile::setDefaultLogContainerSize(uint32_t defaultLogContainerSi
     m_defaultLogContainerSize = defaultLogContainerSize;
 }
 
+void UncompressedFile::copyData(char * s, std::streamsize n) {
+    m_gcount = 0;
+    while (n > 0) {
+        /* find starting log container */
+        std::shared_ptr<LogContainer> logContainer = logContainerContaining(m_tellg);
+        if (!logContainer)
+            break;
+
+        /* offset to read */
+        std::streamoff offset = m_tellg - logContainer->filePosition;
+
+        /* copy data */
+        std::streamsize gcount = std::min(n, static_cast<std::streamsize>(logContainer->uncompressedFileSize - offset));
+        std::copy(logContainer->uncompressedFile.cbegin() + offset, logContainer->uncompressedFile.cbegin() + offset + gcount, s);
+
+        /* remember get count */
+        m_gcount += gcount;
+
+        /* new get position */
+        m_tellg += gcount;
+
+        /* advance */
+        s += gcount;
+
+        /* calculate remaining data to copy */
+        n -= gcount;
+    }
+}
+
+QueueMetrics UncompressedFile::metrics() const {
+    /* mutex lock */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_metrics;
+}
+
 std::shared_ptr<LogContainer> UncompressedFile::logContainerContaining(const std::streampos pos) const {
     /* find logContainer that contains file position */
     std::list<std::shared_ptr<LogContainer>>::const_iterator result = std::find_if(m_data.cbegin(), m_data.cend(), [&pos](std::shared_ptr<LogContainer> logContainer) {
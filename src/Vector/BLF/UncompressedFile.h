@@ -14,6 +14,7 @@
 
 #include "AbstractFile.h"
 #include "LogContainer.h"
+#include "Metrics.h"
 
 #include "vector_blf_export.h"
 
@@ -47,6 +48,11 @@ class VECTOR_BLF_EXPORT UncompressedFile final : public AbstractFile {
     bool good() const override;
     bool eof() const override;
 
+    /**
+     * Reset error state flags.
+     */
+    virtual void clear();
+
     /**
      * Stop further operations. Return from waiting reads.
      */
@@ -59,6 +65,17 @@ class VECTOR_BLF_EXPORT UncompressedFile final : public AbstractFile {
      */
     virtual void write(const std::shared_ptr<LogContainer> & logContainer);
 
+    /**
+     * Read the next defaultLogContainerSize bytes as LogContainer.
+     *
+     * This blocks like read. A complete internal LogContainer, that starts
+     * at the read position, is returned without copying the data, even if
+     * it's smaller. Otherwise the data is copied into a new LogContainer.
+     *
+     * @return log container
+     */
+    virtual std::shared_ptr<LogContainer> readLogContainer();
+
     /**
      * Close the current logContainer.
      */
@@ -78,6 +95,13 @@ class VECTOR_BLF_EXPORT UncompressedFile final : public AbstractFile {
      */
     virtual void setFileSize(std::streamsize fileSize);
 
+    /**
+     * Gets the maximum file size.
+     *
+     * @return maximum file size
+     */
+    virtual std::streamsize bufferSize() const;
+
     /**
      * Sets the maximum file size.
      * Write operations block, if the size is reached.
@@ -105,6 +129,15 @@ class VECTOR_BLF_EXPORT UncompressedFile final : public AbstractFile {
      */
     virtual void setDefaultLogContainerSize(uint32_t defaultLogContainerSize);
 
+    /**
+     * Get the wait times and the maximum fill level.
+     *
+     * They are only collected with OPTION_USE_METRICS.
+     *
+     * @return metrics
+     */
+    virtual QueueMetrics metrics() const;
+
     /** tellg was changed (after read or seekg) */
     std::condition_variable tellgChanged;
 
@@ -142,6 +175,9 @@ class VECTOR_BLF_EXPORT UncompressedFile final : public AbstractFile {
     /** default log container size */
     uint32_t m_defaultLogContainerSize {0x20000};
 
+    /** metrics, collected with OPTION_USE_METRICS */
+    QueueMetrics m_metrics {};
+
     /**
      * Returns the file container, which contains pos.
      *
@@ -153,6 +189,14 @@ class VECTOR_BLF_EXPORT UncompressedFile final : public AbstractFile {
      * @return log container or nullptr
      */
     std::shared_ptr<LogContainer> logContainerContaining(const std::streampos pos) const;
+
+    /**
+     * Copy data from get position, which needs to be available.
+     *
+     * @param[out] s Pointer to data
+     * @param[in] n Size of data
+     */
+    void copyData(char * s, std::streamsize n);
 };
 
 }
@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE BlackBoxRecorder
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/** 10 ms in nanoseconds */
+static const uint64_t tenMs = 10000000;
+
+/**
+ * Create a CAN message.
+ *
+ * @param[in] timeStamp timestamp in nanoseconds
+ * @return CAN message
+ */
+static Vector::BLF::CanMessage * canMessage(uint64_t timeStamp) {
+    auto * canMessage = new Vector::BLF::CanMessage;
+    canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+    canMessage->objectTimeStamp = timeStamp;
+    return canMessage;
+}
+
+/**
+ * Read objects of a file.
+ *
+ * @param[in] fileName file name
+ * @param[out] fileStatistics file statistics
+ * @return objects
+ */
+static std::vector<Vector::BLF::ObjectHeaderBase *> readObjects(const std::string & fileName, Vector::BLF::FileStatistics & fileStatistics) {
+    std::vector<Vector::BLF::ObjectHeaderBase *> objects;
+    Vector::BLF::File file;
+    file.open(fileName, std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+    fileStatistics = file.fileStatistics;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file.read())
+        objects.push_back(ohb);
+    file.close();
+    return objects;
+}
+
+/**
+ * Check that the CAN messages have consecutive timestamps.
+ *
+ * @param[in] objects objects
+ * @param[in] first expected timestamp of the first CAN message
+ * @param[in] last expected timestamp of the last CAN message
+ */
+static void checkTimeStamps(const std::vector<Vector::BLF::ObjectHeaderBase *> & objects, uint64_t first, uint64_t last) {
+    uint64_t timeStamp = first;
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        if (canMessage == nullptr)
+            continue;
+        BOOST_REQUIRE_EQUAL(canMessage->objectTimeStamp, timeStamp);
+        timeStamp += tenMs;
+    }
+    BOOST_CHECK_EQUAL(timeStamp - tenMs, last);
+}
+
+/** trigger by API keeps the pre-trigger history and the post-trigger objects */
+BOOST_AUTO_TEST_CASE(Trigger) {
+    Vector::BLF::BlackBoxRecorder recorder;
+    recorder.defaultLogContainerSize = 0x400;
+    recorder.preTriggerDuration = std::chrono::seconds(1);
+    recorder.postTriggerDuration = std::chrono::milliseconds(500);
+    recorder.open(CMAKE_CURRENT_BINARY_DIR "/test_BlackBoxRecorder_Trigger");
+    BOOST_REQUIRE(recorder.is_open());
+
+    /* 10 s of history, and 1 s after the trigger */
+    for (uint64_t i = 0; i < 1000; ++i)
+        recorder.write(canMessage(i * tenMs));
+    BOOST_CHECK_GT(recorder.memoryUsage(), 0);
+    recorder.trigger();
+    BOOST_CHECK_EQUAL(recorder.memoryUsage(), 0);
+    for (uint64_t i = 1000; i < 1100; ++i)
+        recorder.write(canMessage(i * tenMs));
+    recorder.close();
+    BOOST_CHECK(!recorder.is_open());
+    BOOST_REQUIRE_EQUAL(recorder.fileNames().size(), 1);
+
+    /* read back */
+    Vector::BLF::FileStatistics fileStatistics;
+    std::vector<Vector::BLF::ObjectHeaderBase *> objects = readObjects(recorder.fileNames()[0], fileStatistics);
+    BOOST_REQUIRE(!objects.empty());
+    BOOST_CHECK_EQUAL(fileStatistics.objectCount, objects.size());
+
+    /* history is at least 1 s, but less than one log container more */
+    uint64_t first = Vector::BLF::objectTimeStampNs(*objects.front());
+    BOOST_CHECK_LE(first, 899 * tenMs);
+    BOOST_CHECK_GE(first, 870 * tenMs);
+    checkTimeStamps(objects, first, 1049 * tenMs);
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects)
+        delete ohb;
+}
+
+/** trigger by objects, and extend the post-trigger duration */
+BOOST_AUTO_TEST_CASE(TriggerObjects) {
+    Vector::BLF::BlackBoxRecorder recorder;
+    recorder.defaultLogContainerSize = 0x100;
+    recorder.preTriggerDuration = std::chrono::milliseconds(100);
+    recorder.postTriggerDuration = std::chrono::milliseconds(100);
+    recorder.open(CMAKE_CURRENT_BINARY_DIR "/test_BlackBoxRecorder_TriggerObjects");
+    BOOST_REQUIRE(recorder.is_open());
+
+    for (uint64_t i = 0; i < 300; ++i) {
+        /* trigger condition at 1 s, error frame at 1.05 s and 2 s */
+        if ((i == 100) || (i == 200)) {
+            auto * triggerCondition = new Vector::BLF::TriggerCondition;
+            triggerCondition->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+            triggerCondition->objectTimeStamp = i * tenMs;
+            triggerCondition->triggerCondition = "Trigger";
+            recorder.write(triggerCondition);
+        }
+        if (i == 105) {
+            auto * canErrorFrame = new Vector::BLF::CanErrorFrame;
+            canErrorFrame->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+            canErrorFrame->objectTimeStamp = i * tenMs;
+            recorder.write(canErrorFrame);
+        }
+        recorder.write(canMessage(i * tenMs));
+    }
+    recorder.close();
+    BOOST_REQUIRE_EQUAL(recorder.fileNames().size(), 2);
+
+    /* first file contains both triggers, and ends 100 ms after the second */
+    Vector::BLF::FileStatistics fileStatistics;
+    std::vector<Vector::BLF::ObjectHeaderBase *> objects = readObjects(recorder.fileNames()[0], fileStatistics);
+    BOOST_REQUIRE(!objects.empty());
+    BOOST_CHECK_EQUAL(fileStatistics.objectCount, objects.size());
+    std::vector<Vector::BLF::ObjectType> triggers;
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects)
+        if (ohb->objectType != Vector::BLF::ObjectType::CAN_MESSAGE)
+            triggers.push_back(ohb->objectType);
+    BOOST_REQUIRE_EQUAL(triggers.size(), 2);
+    BOOST_CHECK(triggers[0] == Vector::BLF::ObjectType::TRIGGER_CONDITION);
+    BOOST_CHECK(triggers[1] == Vector::BLF::ObjectType::CAN_ERROR);
+    checkTimeStamps(objects, Vector::BLF::objectTimeStampNs(*objects.front()), 115 * tenMs);
+    BOOST_CHECK_LE(Vector::BLF::objectTimeStampNs(*objects.front()), 90 * tenMs);
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects)
+        delete ohb;
+
+    /* second file */
+    objects = readObjects(recorder.fileNames()[1], fileStatistics);
+    BOOST_REQUIRE(!objects.empty());
+    checkTimeStamps(objects, Vector::BLF::objectTimeStampNs(*objects.front()), 210 * tenMs);
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects)
+        delete ohb;
+}
+
+/** history is limited by memory */
+BOOST_AUTO_TEST_CASE(MaxMemory) {
+    Vector::BLF::BlackBoxRecorder recorder;
+    recorder.defaultLogContainerSize = 0x400;
+    recorder.compressionLevel = 0;
+    recorder.maxMemory = 0x1000;
+    recorder.open(CMAKE_CURRENT_BINARY_DIR "/test_BlackBoxRecorder_MaxMemory");
+    BOOST_REQUIRE(recorder.is_open());
+    for (uint64_t i = 0; i < 1000; ++i) {
+        recorder.write(canMessage(i * tenMs));
+        BOOST_REQUIRE_LE(recorder.memoryUsage(), 0x1000);
+    }
+    BOOST_CHECK_GT(recorder.memoryUsage(), 0x1000 - 0x400);
+    recorder.trigger();
+    recorder.close();
+
+    /* read back */
+    BOOST_REQUIRE_EQUAL(recorder.fileNames().size(), 1);
+    Vector::BLF::FileStatistics fileStatistics;
+    std::vector<Vector::BLF::ObjectHeaderBase *> objects = readObjects(recorder.fileNames()[0], fileStatistics);
+    BOOST_REQUIRE(!objects.empty());
+    BOOST_CHECK_LE(objects.size(), 5 * 0x400 / 48);
+    checkTimeStamps(objects, Vector::BLF::objectTimeStampNs(*objects.front()), 999 * tenMs);
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects)
+        delete ohb;
+}
+
+/** objects, that span several log containers, are dropped completely */
+BOOST_AUTO_TEST_CASE(LargeObjects) {
+    Vector::BLF::BlackBoxRecorder recorder;
+    recorder.defaultLogContainerSize = 0x100;
+    recorder.preTriggerDuration = std::chrono::milliseconds(100);
+    recorder.open(CMAKE_CURRENT_BINARY_DIR "/test_BlackBoxRecorder_LargeObjects");
+    BOOST_REQUIRE(recorder.is_open());
+    for (uint64_t i = 0; i < 50; ++i) {
+        recorder.write(canMessage(i * tenMs));
+        auto * eventComment = new Vector::BLF::EventComment;
+        eventComment->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        eventComment->objectTimeStamp = i * tenMs;
+        eventComment->text = std::string(500, 'x');
+        recorder.write(eventComment);
+    }
+    recorder.trigger();
+    recorder.close();
+
+    /* read back */
+    BOOST_REQUIRE_EQUAL(recorder.fileNames().size(), 1);
+    Vector::BLF::FileStatistics fileStatistics;
+    std::vector<Vector::BLF::ObjectHeaderBase *> objects = readObjects(recorder.fileNames()[0], fileStatistics);
+    BOOST_REQUIRE(!objects.empty());
+    BOOST_CHECK_EQUAL(fileStatistics.objectCount, objects.size());
+    BOOST_CHECK_LT(objects.size(), 100);
+    checkTimeStamps(objects, Vector::BLF::objectTimeStampNs(*objects.front()), 49 * tenMs);
+    for (Vector::BLF::ObjectHeaderBase * ohb : objects) {
+        auto * eventComment = dynamic_cast<Vector::BLF::EventComment *>(ohb);
+        if (eventComment != nullptr)
+            BOOST_CHECK_EQUAL(eventComment->text.size(), 500);
+        delete ohb;
+    }
+}
+
+/** no writes before open or after close */
+BOOST_AUTO_TEST_CASE(WriteAfterClose) {
+    Vector::BLF::BlackBoxRecorder recorder;
+    BOOST_CHECK_THROW(recorder.write(canMessage(0)), Vector::BLF::Exception);
+    BOOST_CHECK_THROW(recorder.trigger(), Vector::BLF::Exception);
+    recorder.open(CMAKE_CURRENT_BINARY_DIR "/test_BlackBoxRecorder_WriteAfterClose");
+    recorder.write(canMessage(0));
+    recorder.close();
+    BOOST_CHECK_THROW(recorder.write(canMessage(1)), Vector::BLF::Exception);
+    BOOST_CHECK(recorder.fileNames().empty());
+}
@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE BlfArchive
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/**
+ * Write a file with CAN messages, which have the id as timestamp in
+ * microseconds.
+ *
+ * @param[in] fileName file name
+ * @param[in] count number of CAN messages
+ */
+static void writeFile(const char * fileName, uint32_t count) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x1000);
+    file.open(fileName, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < count; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        canMessage->objectTimeStamp = id * 1000;
+        file.write(canMessage);
+    }
+    file.close();
+}
+
+/**
+ * Read the ids of all CAN messages from a cursor.
+ *
+ * @param[in] cursor cursor
+ * @return ids
+ */
+static std::vector<uint32_t> readIds(Vector::BLF::BlfArchive::Cursor & cursor) {
+    std::vector<uint32_t> ids;
+    while (Vector::BLF::ObjectHeaderBase * ohb = cursor.read()) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        ids.push_back(canMessage->id);
+        delete ohb;
+    }
+    BOOST_CHECK(cursor.eof());
+    return ids;
+}
+
+/** all objects are read in order */
+BOOST_AUTO_TEST_CASE(ReadAll) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_ReadAll.blf", 5000);
+    Vector::BLF::BlfArchive archive;
+    archive.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_ReadAll.blf");
+    BOOST_REQUIRE(archive.is_open());
+    BOOST_CHECK_EQUAL(archive.fileStatistics.objectCount, 5000);
+    BOOST_CHECK_GT(archive.logContainerCount(), 50);
+    BOOST_CHECK_EQUAL(archive.restorePoints().size(), 4);
+
+    /* restore point containers are read as well */
+    Vector::BLF::BlfArchive::Cursor cursor(archive);
+    uint32_t id = 0;
+    uint32_t restorePointContainers = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = cursor.read()) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        if (canMessage != nullptr) {
+            BOOST_CHECK_EQUAL(canMessage->id, id);
+            id++;
+        } else {
+            BOOST_CHECK(ohb->objectType == Vector::BLF::ObjectType::Unknown115);
+            restorePointContainers++;
+        }
+        delete ohb;
+    }
+    BOOST_CHECK_EQUAL(id, 5000);
+    BOOST_CHECK_GT(restorePointContainers, 0);
+    archive.close();
+    BOOST_CHECK(!archive.is_open());
+}
+
+/** seek to timestamps, using the restore points */
+BOOST_AUTO_TEST_CASE(Seek) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_Seek.blf", 5000);
+    Vector::BLF::BlfArchive archive;
+    archive.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_Seek.blf");
+    BOOST_REQUIRE(archive.is_open());
+    Vector::BLF::BlfArchive::Cursor cursor(archive);
+    cursor.objectTypes.insert(Vector::BLF::ObjectType::CAN_MESSAGE);
+
+    /* before, at and after restore points */
+    for (uint32_t id : {
+                2500, 1000, 1001, 999, 0, 4999
+            }) {
+        cursor.seek(id * 1000);
+        Vector::BLF::ObjectHeaderBase * ohb = cursor.read();
+        BOOST_REQUIRE(ohb != nullptr);
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        BOOST_CHECK_EQUAL(canMessage->id, id);
+        delete ohb;
+    }
+
+    /* behind the end */
+    cursor.seek(5000 * 1000);
+    BOOST_CHECK(cursor.read() == nullptr);
+    BOOST_CHECK(cursor.eof());
+}
+
+/** objects are filtered by type and time */
+BOOST_AUTO_TEST_CASE(Filters) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_Filters.blf", 5000);
+    Vector::BLF::BlfArchive archive;
+    archive.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_Filters.blf");
+    BOOST_REQUIRE(archive.is_open());
+
+    /* time range */
+    Vector::BLF::BlfArchive::Cursor cursor(archive);
+    cursor.objectTypes.insert(Vector::BLF::ObjectType::CAN_MESSAGE);
+    cursor.beginTimeStamp = 1500 * 1000;
+    cursor.endTimeStamp = 1599 * 1000;
+    cursor.seek(cursor.beginTimeStamp);
+    std::vector<uint32_t> ids = readIds(cursor);
+    BOOST_REQUIRE_EQUAL(ids.size(), 100);
+    BOOST_CHECK_EQUAL(ids.front(), 1500);
+    BOOST_CHECK_EQUAL(ids.back(), 1599);
+
+    /* object type */
+    Vector::BLF::BlfArchive::Cursor cursor2(archive);
+    cursor2.objectTypes.insert(Vector::BLF::ObjectType::CAN_ERROR);
+    BOOST_CHECK(cursor2.read() == nullptr);
+    BOOST_CHECK(cursor2.eof());
+}
+
+/** objects, that span several log containers */
+BOOST_AUTO_TEST_CASE(LargeObjects) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_LargeObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t i = 0; i < 10; i++) {
+        auto * eventComment = new Vector::BLF::EventComment;
+        eventComment->text = std::string(500 + i, 'x');
+        file.write(eventComment);
+    }
+    file.close();
+
+    Vector::BLF::BlfArchive archive;
+    archive.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_LargeObjects.blf");
+    BOOST_REQUIRE(archive.is_open());
+    Vector::BLF::BlfArchive::Cursor cursor(archive);
+    cursor.objectTypes.insert(Vector::BLF::ObjectType::EVENT_COMMENT);
+    for (uint32_t i = 0; i < 10; i++) {
+        Vector::BLF::ObjectHeaderBase * ohb = cursor.read();
+        auto * eventComment = dynamic_cast<Vector::BLF::EventComment *>(ohb);
+        BOOST_REQUIRE(eventComment != nullptr);
+        BOOST_CHECK_EQUAL(eventComment->text, std::string(500 + i, 'x'));
+        delete ohb;
+    }
+    BOOST_CHECK(cursor.read() == nullptr);
+}
+
+/** cursors on the same archive are used by several threads */
+BOOST_AUTO_TEST_CASE(ConcurrentCursors) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_ConcurrentCursors.blf", 5000);
+    Vector::BLF::BlfArchive archive;
+    archive.logContainerCache = std::make_shared<Vector::BLF::LogContainerCache>();
+    archive.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_ConcurrentCursors.blf");
+    BOOST_REQUIRE(archive.is_open());
+
+    /* each thread reads a range of 1000 objects several times */
+    std::atomic<uint32_t> errors {0};
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < 5; thread++) {
+        threads.push_back(std::thread([&archive, &errors, thread]() {
+            for (int pass = 0; pass < 3; pass++) {
+                Vector::BLF::BlfArchive::Cursor cursor(archive);
+                cursor.objectTypes.insert(Vector::BLF::ObjectType::CAN_MESSAGE);
+                cursor.beginTimeStamp = thread * 1000 * 1000;
+                cursor.endTimeStamp = cursor.beginTimeStamp + 999 * 1000;
+                cursor.seek(cursor.beginTimeStamp);
+                uint32_t id = thread * 1000;
+                while (Vector::BLF::ObjectHeaderBase * ohb = cursor.read()) {
+                    auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+                    if ((canMessage == nullptr) || (canMessage->id != id))
+                        errors++;
+                    id++;
+                    delete ohb;
+                }
+                if (id != (thread + 1) * 1000)
+                    errors++;
+            }
+        }));
+    }
+    for (std::thread & thread : threads)
+        thread.join();
+    BOOST_CHECK_EQUAL(errors, 0);
+    BOOST_CHECK_GT(archive.logContainerCache->hits(), 0);
+}
+
+/** errors on open */
+BOOST_AUTO_TEST_CASE(OpenErrors) {
+    Vector::BLF::BlfArchive archive;
+    BOOST_CHECK_THROW(Vector::BLF::BlfArchive::Cursor cursor(archive), Vector::BLF::Exception);
+    BOOST_CHECK_THROW(archive.open(CMAKE_CURRENT_BINARY_DIR "/test_BlfArchive_NotExisting.blf"), Vector::BLF::Exception);
+    BOOST_CHECK(!archive.is_open());
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE CancellationToken
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <Vector/BLF.h>
+
+/**
+ * Write a file with CAN messages in small LogContainers.
+ *
+ * @param[in] fileName file name
+ * @param[in] count number of CAN messages
+ */
+static void writeFile(const char * fileName, uint32_t count) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x1000);
+    file.open(fileName, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < count; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+}
+
+/** registered functions are called once on cancel */
+BOOST_AUTO_TEST_CASE(RegisterFunction) {
+    Vector::BLF::CancellationToken cancellationToken;
+    int called1 = 0;
+    int called2 = 0;
+    uint64_t id1 = cancellationToken.registerFunction([&called1]() {
+        called1++;
+    });
+    uint64_t id2 = cancellationToken.registerFunction([&called2]() {
+        called2++;
+    });
+    BOOST_CHECK_NE(id1, id2);
+    cancellationToken.unregisterFunction(id2);
+    BOOST_CHECK(!cancellationToken.cancelled());
+
+    cancellationToken.cancel();
+    cancellationToken.cancel();
+    BOOST_CHECK(cancellationToken.cancelled());
+    BOOST_CHECK_EQUAL(called1, 1);
+    BOOST_CHECK_EQUAL(called2, 0);
+
+    /* functions registered later are called directly */
+    int called3 = 0;
+    cancellationToken.registerFunction([&called3]() {
+        called3++;
+    });
+    BOOST_CHECK_EQUAL(called3, 1);
+}
+
+/** reading is stopped by a token from another thread */
+BOOST_AUTO_TEST_CASE(CancelRead) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_CancellationToken_CancelRead.blf", 100000);
+    Vector::BLF::File file;
+    file.cancellationToken = std::make_shared<Vector::BLF::CancellationToken>();
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_CancellationToken_CancelRead.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    /* read some objects */
+    for (int i = 0; i < 10; i++) {
+        Vector::BLF::ObjectHeaderBase * ohb = file.read();
+        BOOST_REQUIRE(ohb != nullptr);
+        delete ohb;
+    }
+
+    /* cancel from another thread */
+    std::thread thread([&file]() {
+        file.cancellationToken->cancel();
+    });
+    thread.join();
+    BOOST_CHECK(file.cancelled());
+
+    /* queued objects are not passed on */
+    BOOST_CHECK(file.read() == nullptr);
+    BOOST_CHECK(file.eof());
+    file.close();
+    BOOST_CHECK_LT(file.progress().objectsRead, 100000);
+}
+
+/** reading is cancelled from the progress callback */
+BOOST_AUTO_TEST_CASE(CancelFromProgressCallback) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_CancellationToken_CancelFromProgressCallback.blf", 100000);
+    Vector::BLF::File file;
+    file.progressInterval = std::chrono::milliseconds(0);
+    file.progressCallback = [&file](const Vector::BLF::Progress & progress) {
+        if (progress.logContainersRead >= 5)
+            file.cancel();
+    };
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_CancellationToken_CancelFromProgressCallback.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    uint32_t objectCount = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file.read()) {
+        objectCount++;
+        delete ohb;
+    }
+    BOOST_CHECK(file.cancelled());
+    BOOST_CHECK_LT(objectCount, 100000);
+    BOOST_CHECK_LT(file.progress().compressedBytesRead, file.fileStatistics.fileSize);
+    file.close();
+}
+
+/** files opened for writing are not affected */
+BOOST_AUTO_TEST_CASE(CancelWrite) {
+    auto cancellationToken = std::make_shared<Vector::BLF::CancellationToken>();
+    cancellationToken->cancel();
+    Vector::BLF::File file;
+    file.cancellationToken = cancellationToken;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_CancellationToken_CancelWrite.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    file.write(new Vector::BLF::CanMessage);
+    file.cancel();
+    BOOST_CHECK(!file.cancelled());
+    file.close();
+    BOOST_CHECK_EQUAL(file.fileStatistics.objectCount, 1);
+}
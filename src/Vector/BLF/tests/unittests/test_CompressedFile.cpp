@@ -9,6 +9,11 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include <Vector/BLF.h>
 
 /** Test read operations on a blf file. */
@@ -44,3 +49,123 @@ BOOST_AUTO_TEST_CASE(ReadTest) {
     compressedFile.close();
     BOOST_CHECK(!compressedFile.is_open());
 }
+
+/** Test reads beyond end of file and across the read-ahead buffer. */
+BOOST_AUTO_TEST_CASE(ReadAhead) {
+    /* reference data over several read-ahead buffers */
+    std::vector<char> expected(10000);
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        expected[i] = static_cast<char>(i * 7 + i / 256);
+    std::ofstream ofs(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_ReadAhead.bin", std::ios_base::out | std::ios_base::binary);
+    ofs.write(expected.data(), static_cast<std::streamsize>(expected.size()));
+    ofs.close();
+
+    for (bool directIo : {false, true}) {
+        Vector::BLF::CompressedFile compressedFile;
+        compressedFile.readAheadSize = 1; // rounded up to the alignment
+        compressedFile.readAheadDepth = 3;
+        compressedFile.directIo = directIo;
+        compressedFile.dropPageCache = true;
+        compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_ReadAhead.bin", std::ios_base::in | std::ios_base::binary);
+        BOOST_REQUIRE(compressedFile.is_open());
+
+        /* read in odd sized blocks */
+        std::vector<char> data(expected.size());
+        std::size_t position = 0;
+        while (position < data.size()) {
+            std::streamsize size = std::min<std::streamsize>(1000, static_cast<std::streamsize>(data.size() - position));
+            compressedFile.read(data.data() + position, size);
+            BOOST_REQUIRE_EQUAL(compressedFile.gcount(), size);
+            position += static_cast<std::size_t>(size);
+        }
+        BOOST_CHECK(data == expected);
+        BOOST_CHECK(compressedFile.good());
+
+        /* read beyond end of file */
+        compressedFile.seekg(-2, std::ios_base::end);
+        BOOST_CHECK_EQUAL(compressedFile.tellg(), static_cast<std::streamoff>(expected.size() - 2));
+        char buffer[4];
+        compressedFile.read(buffer, 4);
+        BOOST_CHECK_EQUAL(compressedFile.gcount(), 2);
+        BOOST_CHECK(compressedFile.eof());
+        BOOST_CHECK(!compressedFile.good());
+        BOOST_CHECK_EQUAL(compressedFile.tellg(), -1);
+
+        /* recover and read backwards */
+        compressedFile.clear();
+        compressedFile.seekg(4, std::ios_base::beg);
+        compressedFile.read(buffer, 4);
+        BOOST_CHECK_EQUAL(compressedFile.gcount(), 4);
+        BOOST_CHECK(std::equal(buffer, buffer + 4, expected.begin() + 4));
+        compressedFile.close();
+        BOOST_CHECK(!compressedFile.is_open());
+    }
+}
+
+/** Test open of a missing file. */
+BOOST_AUTO_TEST_CASE(OpenMissingFile) {
+    Vector::BLF::CompressedFile compressedFile;
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_missing.blf", std::ios_base::in | std::ios_base::binary);
+    BOOST_CHECK(!compressedFile.is_open());
+    BOOST_CHECK(!compressedFile.good());
+}
+
+/** Test that gathered writes are written in order. */
+BOOST_AUTO_TEST_CASE(WriteGather) {
+    Vector::BLF::CompressedFile compressedFile;
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_WriteGather.bin", std::ios_base::out | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    compressedFile.write("LOGG", 4);
+    const Vector::BLF::AbstractFile::WriteBuffer buffers[3] {
+        { "abc", 3 },
+        { "", 0 },
+        { "defg", 4 }
+    };
+    compressedFile.writeGather(buffers, 3);
+    BOOST_CHECK_EQUAL(compressedFile.tellp(), 11);
+
+    /* overwrite in place */
+    compressedFile.seekp(4);
+    compressedFile.write("A", 1);
+    BOOST_CHECK(compressedFile.good());
+    compressedFile.close();
+
+    /* read back */
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_WriteGather.bin", std::ios_base::in | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    char data[12] {};
+    compressedFile.read(data, 12);
+    BOOST_CHECK_EQUAL(compressedFile.gcount(), 11);
+    BOOST_CHECK_EQUAL(std::string(data), "LOGGAbcdefg");
+    compressedFile.close();
+}
+
+/** Test that writes in append mode go to the end of the file. */
+BOOST_AUTO_TEST_CASE(WriteAppend) {
+    Vector::BLF::CompressedFile compressedFile;
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_WriteAppend.bin", std::ios_base::out | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    compressedFile.write("LOGG", 4);
+    compressedFile.close();
+
+    /* append */
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_WriteAppend.bin", std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    compressedFile.seekp(0);
+    compressedFile.write("abc", 3);
+    BOOST_CHECK_EQUAL(compressedFile.tellp(), 7);
+    compressedFile.sync();
+    BOOST_CHECK(compressedFile.good());
+    compressedFile.close();
+
+    /* read back */
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_CompressedFile_WriteAppend.bin", std::ios_base::in | std::ios_base::ate | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    BOOST_CHECK_EQUAL(compressedFile.tellg(), 7);
+    compressedFile.seekg(0, std::ios_base::beg);
+    char data[8] {};
+    compressedFile.read(data, 8);
+    BOOST_CHECK_EQUAL(compressedFile.gcount(), 7);
+    BOOST_CHECK_EQUAL(std::string(data), "LOGGabc");
+    compressedFile.close();
+}
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE ConcurrentFileWriter
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/**
+ * Create a CAN message.
+ *
+ * @param[in] channel channel
+ * @param[in] timeStamp timestamp in nanoseconds
+ * @return CAN message
+ */
+static Vector::BLF::CanMessage * canMessage(uint16_t channel, uint64_t timeStamp) {
+    auto * canMessage = new Vector::BLF::CanMessage;
+    canMessage->channel = channel;
+    canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+    canMessage->objectTimeStamp = timeStamp;
+    return canMessage;
+}
+
+/** several producers are merged in timestamp order */
+BOOST_AUTO_TEST_CASE(MultipleProducers) {
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ConcurrentFileWriter_MultipleProducers.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    Vector::BLF::ConcurrentFileWriter writer(file);
+    writer.reorderWindow = std::chrono::seconds(10);
+    writer.stagingBufferSize = 256;
+
+    /* each producer writes every fourth timestamp */
+    std::vector<std::thread> producers;
+    for (uint16_t channel = 0; channel < 4; ++channel) {
+        producers.push_back(std::thread([&writer, channel]() {
+            for (uint64_t i = 0; i < 10000; ++i)
+                writer.write(canMessage(channel, i * 4 + channel));
+        }));
+    }
+    for (std::thread & producer : producers)
+        producer.join();
+    writer.close();
+    BOOST_CHECK_EQUAL(writer.lateObjectCount(), 0);
+    file.close();
+
+    /* read back */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_ConcurrentFileWriter_MultipleProducers.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.fileStatistics.objectCount, 40000);
+    uint64_t timeStamp = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        /* skip restore points */
+        if (ohb->objectType == Vector::BLF::ObjectType::Unknown115) {
+            delete ohb;
+            continue;
+        }
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        BOOST_REQUIRE_EQUAL(canMessage->objectTimeStamp, timeStamp);
+        BOOST_CHECK_EQUAL(canMessage->channel, timeStamp % 4);
+        timeStamp++;
+        delete ohb;
+    }
+    BOOST_CHECK_EQUAL(timeStamp, 40000);
+    file2.close();
+}
+
+/** objects after the reorder window are counted as late */
+BOOST_AUTO_TEST_CASE(LateObjects) {
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ConcurrentFileWriter_LateObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    Vector::BLF::ConcurrentFileWriter writer(file);
+    writer.reorderWindow = std::chrono::nanoseconds(10);
+
+    /* wait until the first objects are written */
+    writer.write(canMessage(1, 1000));
+    writer.write(canMessage(1, 2000));
+    for (int i = 0; (i < 1000) && (file.currentObjectCount < 2); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BOOST_REQUIRE_EQUAL(file.currentObjectCount, 2);
+
+    /* this one is too late */
+    writer.write(canMessage(2, 500));
+    writer.close();
+    BOOST_CHECK_EQUAL(writer.lateObjectCount(), 1);
+    file.close();
+    BOOST_CHECK_EQUAL(file.fileStatistics.objectCount, 3);
+}
+
+/** no writes after close */
+BOOST_AUTO_TEST_CASE(WriteAfterClose) {
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ConcurrentFileWriter_WriteAfterClose.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    Vector::BLF::ConcurrentFileWriter writer(file);
+    writer.write(canMessage(1, 0));
+    writer.close();
+    BOOST_CHECK_THROW(writer.write(canMessage(1, 1)), Vector::BLF::Exception);
+    file.close();
+    BOOST_CHECK_EQUAL(file.fileStatistics.objectCount, 1);
+}
+
+/** close while producers are still writing */
+BOOST_AUTO_TEST_CASE(CloseWhileWriting) {
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ConcurrentFileWriter_CloseWhileWriting.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    Vector::BLF::ConcurrentFileWriter writer(file);
+    writer.stagingBufferSize = 16;
+
+    /* producers write until the writer is closed */
+    std::atomic<uint32_t> writtenCount {0};
+    std::vector<std::thread> producers;
+    for (uint16_t channel = 0; channel < 4; ++channel) {
+        producers.push_back(std::thread([&writer, &writtenCount, channel]() {
+            for (uint64_t i = 0; ; ++i) {
+                try {
+                    writer.write(canMessage(channel, i));
+                } catch (const Vector::BLF::Exception &) {
+                    return;
+                }
+                writtenCount++;
+            }
+        }));
+    }
+    while (writtenCount < 1000)
+        std::this_thread::yield();
+    writer.close();
+    for (std::thread & producer : producers)
+        producer.join();
+    file.close();
+
+    /* every accepted object is in the file */
+    BOOST_CHECK_EQUAL(file.fileStatistics.objectCount, writtenCount);
+}
@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE Coroutines
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/**
+ * Write a file with 1000 CanMessages, and a CanFdMessage64 after every
+ * tenth of them.
+ *
+ * @param[in] fileName file name
+ */
+static void writeFile(const std::string & fileName) {
+    Vector::BLF::File file;
+    file.writeRestorePoints = false;
+    file.open(fileName, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 1000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+        if (id % 10 == 9) {
+            auto * canFdMessage64 = new Vector::BLF::CanFdMessage64;
+            canFdMessage64->id = id;
+            file.write(canFdMessage64);
+        }
+    }
+    file.close();
+}
+
+/** coroutine, that is started directly and not awaited */
+struct Task {
+    /** promise of the coroutine */
+    struct promise_type {
+        Task get_return_object() {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() {
+        }
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+};
+
+/** single threaded executor */
+class Executor {
+  public:
+    /**
+     * Post a coroutine to resume.
+     *
+     * @param[in] handle coroutine handle
+     */
+    void post(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_handles.push_back(handle);
+        m_posted.notify_all();
+    }
+
+    /**
+     * Resume posted coroutines, until all tasks are finished.
+     *
+     * @param[in] tasks number of tasks
+     */
+    void run(uint32_t tasks) {
+        while (finished < tasks) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_posted.wait(lock, [this]() {
+                return !m_handles.empty();
+            });
+            std::coroutine_handle<> handle = m_handles.front();
+            m_handles.pop_front();
+            lock.unlock();
+            handle.resume();
+        }
+    }
+
+    /** number of finished tasks, only changed on the executor thread */
+    uint32_t finished {0};
+
+  private:
+    /** mutex */
+    std::mutex m_mutex {};
+
+    /** coroutine was posted */
+    std::condition_variable m_posted {};
+
+    /** coroutines to resume */
+    std::deque<std::coroutine_handle<>> m_handles {};
+};
+
+/**
+ * Read all objects of a file with co_await, resumed by the executor.
+ *
+ * @param[in] file file opened for reading
+ * @param[in] executor executor
+ * @param[out] canMessages number of CanMessages in order
+ */
+static Task readFile(Vector::BLF::File & file, Executor & executor, uint32_t & canMessages) {
+    auto resume = [&executor](std::coroutine_handle<> handle) {
+        executor.post(handle);
+    };
+    for (;;) {
+        std::vector<std::unique_ptr<Vector::BLF::ObjectHeaderBase>> objects = co_await Vector::BLF::readBatch(file, 64, resume);
+        if (objects.empty())
+            break;
+        for (auto & ohb : objects) {
+            if ((ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE) &&
+                    (static_cast<Vector::BLF::CanMessage &>(*ohb).id == canMessages))
+                canMessages++;
+        }
+    }
+    executor.finished++;
+}
+
+/**
+ * Count all objects of a file with co_await, resumed by the File thread.
+ *
+ * @param[in] file file opened for reading
+ * @param[out] objectCount number of objects
+ */
+static Task readFileInline(Vector::BLF::File & file, std::promise<std::size_t> & objectCount) {
+    std::size_t count = 0;
+    for (;;) {
+        std::vector<std::unique_ptr<Vector::BLF::ObjectHeaderBase>> objects = co_await Vector::BLF::readBatch(file);
+        if (objects.empty())
+            break;
+        count += objects.size();
+    }
+    objectCount.set_value(count);
+}
+
+/** all objects as stream */
+BOOST_AUTO_TEST_CASE(ObjectStream) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_ObjectStream.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_ObjectStream.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    uint32_t canMessages = 0;
+    std::vector<std::unique_ptr<Vector::BLF::ObjectHeaderBase>> canFdMessages64;
+    for (auto & ohb : Vector::BLF::objectStream(file, 16)) {
+        BOOST_REQUIRE(ohb);
+        if (ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE) {
+            BOOST_CHECK_EQUAL(static_cast<Vector::BLF::CanMessage &>(*ohb).id, canMessages);
+            canMessages++;
+        } else {
+            /* keep object */
+            canFdMessages64.push_back(std::move(ohb));
+        }
+    }
+    BOOST_CHECK_EQUAL(canMessages, 1000);
+    BOOST_CHECK_EQUAL(canFdMessages64.size(), 100);
+    BOOST_CHECK(file.eof());
+    file.close();
+}
+
+/** objects of one class as stream */
+BOOST_AUTO_TEST_CASE(TypedObjectStream) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_TypedObjectStream.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_TypedObjectStream.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    uint32_t id = 9;
+    for (auto & canFdMessage64 : Vector::BLF::typedObjectStream<Vector::BLF::CanFdMessage64>(file)) {
+        BOOST_CHECK_EQUAL(canFdMessage64->id, id);
+        id += 10;
+    }
+    BOOST_CHECK_EQUAL(id, 1009);
+    file.close();
+}
+
+/** several files are read by one executor thread */
+BOOST_AUTO_TEST_CASE(ReadBatchOnExecutor) {
+    const uint32_t files = 4;
+    std::vector<std::unique_ptr<Vector::BLF::File>> blfFiles;
+    for (uint32_t i = 0; i < files; i++) {
+        std::string fileName = CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_ReadBatchOnExecutor" + std::to_string(i) + ".blf";
+        writeFile(fileName);
+        blfFiles.emplace_back(new Vector::BLF::File);
+        blfFiles.back()->open(fileName, std::ios_base::in);
+        BOOST_REQUIRE(blfFiles.back()->is_open());
+    }
+
+    Executor executor;
+    std::vector<uint32_t> canMessages(files, 0);
+    for (uint32_t i = 0; i < files; i++)
+        readFile(*blfFiles[i], executor, canMessages[i]);
+    executor.run(files);
+
+    for (uint32_t i = 0; i < files; i++) {
+        BOOST_CHECK_EQUAL(canMessages[i], 1000);
+        BOOST_CHECK(blfFiles[i]->eof());
+        blfFiles[i]->close();
+    }
+}
+
+/** coroutine is resumed directly by the File thread */
+BOOST_AUTO_TEST_CASE(ReadBatchInline) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_ReadBatchInline.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_Coroutines_ReadBatchInline.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    std::promise<std::size_t> objectCount;
+    readFileInline(file, objectCount);
+    std::future<std::size_t> result = objectCount.get_future();
+    BOOST_REQUIRE(result.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    BOOST_CHECK_EQUAL(result.get(), 1100);
+    BOOST_CHECK(file.eof());
+    file.close();
+}
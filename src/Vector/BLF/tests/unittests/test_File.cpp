@@ -9,6 +9,15 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <Vector/BLF.h>
 
 /** check error conditions in open */
@@ -158,6 +167,39 @@ BOOST_AUTO_TEST_CASE(fileWithUnknownObjectType) {
     file.close();
 }
 
+/** unsupported objects, that span several log containers, are skipped */
+BOOST_AUTO_TEST_CASE(skipLargeUnsupportedObjects) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_skipLargeUnsupportedObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 10; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+        auto * appText = new Vector::BLF::AppText;
+        appText->text = std::string(500, 'x');
+        file.write(appText);
+    }
+    file.close();
+
+    /* AppText is not supported for reading */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_skipLargeUnsupportedObjects.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    uint32_t id = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        BOOST_CHECK_EQUAL(canMessage->id, id);
+        id++;
+        delete ohb;
+    }
+    BOOST_CHECK_EQUAL(id, 10);
+    file2.close();
+}
+
 /** Test open and close cycle to see if there is nothing freed forcefully. */
 BOOST_AUTO_TEST_CASE(OpenCloseCycles) {
     Vector::BLF::File logfile;
@@ -165,3 +207,721 @@ BOOST_AUTO_TEST_CASE(OpenCloseCycles) {
     logfile.open(CMAKE_CURRENT_BINARY_DIR "test.blf", std::ios_base::out);
     logfile.close();
 }
+
+/** Test appending objects to an existing file. */
+BOOST_AUTO_TEST_CASE(AppendToExistingFile) {
+    Vector::BLF::File file;
+
+    /* write a file with three CanMessages */
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Append.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 3; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+
+    /* append two more CanMessages */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Append.blf", std::ios_base::app);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.fileStatistics.objectCount, 3);
+    for (uint32_t id = 3; id < 5; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file2.write(canMessage);
+    }
+    file2.close();
+
+    /* read all five CanMessages */
+    Vector::BLF::File file3;
+    file3.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Append.blf", std::ios_base::in);
+    BOOST_REQUIRE(file3.is_open());
+    BOOST_CHECK_EQUAL(file3.fileStatistics.objectCount, 5);
+    uint32_t id = 0;
+    while (file3.good()) {
+        Vector::BLF::ObjectHeaderBase * ohb = file3.read();
+        if (ohb == nullptr)
+            break;
+        if (ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE) {
+            auto * canMessage = static_cast<Vector::BLF::CanMessage *>(ohb);
+            BOOST_CHECK_EQUAL(canMessage->id, id);
+            id++;
+        }
+        delete ohb;
+    }
+    BOOST_CHECK_EQUAL(id, 5);
+    file3.close();
+}
+
+/** Test that appending to a foreign file leaves it untouched. */
+BOOST_AUTO_TEST_CASE(AppendToForeignFile) {
+    /* write a text file */
+    std::string text;
+    for (int line = 0; line < 50; line++)
+        text += "This is line " + std::to_string(line) + " of a text file.\n";
+    std::ofstream ofs(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendToForeignFile.txt", std::ios_base::out | std::ios_base::binary);
+    ofs << text;
+    ofs.close();
+
+    /* append */
+    {
+        Vector::BLF::File file;
+        BOOST_CHECK_THROW(file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendToForeignFile.txt", std::ios_base::app), Vector::BLF::Exception);
+        BOOST_CHECK(!file.is_open());
+    }
+
+    /* file is byte-identical */
+    std::ifstream ifs(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendToForeignFile.txt", std::ios_base::in | std::ios_base::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    BOOST_CHECK(content == text);
+}
+
+/** Test that appending to an empty file starts a new file. */
+BOOST_AUTO_TEST_CASE(AppendToEmptyFile) {
+    /* create an empty file */
+    std::ofstream ofs(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendToEmptyFile.blf", std::ios_base::out | std::ios_base::binary);
+    ofs.close();
+
+    /* append */
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendToEmptyFile.blf", std::ios_base::app);
+    BOOST_REQUIRE(file.is_open());
+    file.write(new Vector::BLF::CanMessage);
+    file.close();
+
+    /* read */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendToEmptyFile.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.fileStatistics.objectCount, 1);
+    Vector::BLF::ObjectHeaderBase * ohb = file2.read();
+    BOOST_REQUIRE(ohb != nullptr);
+    BOOST_CHECK(ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE);
+    delete ohb;
+    file2.close();
+}
+
+/**
+ * Read the restore points of a file.
+ *
+ * @param[in] fileName file name
+ * @param[out] restorePointContainers number of RestorePointContainers
+ * @return restore points
+ */
+static Vector::BLF::RestorePoints readRestorePoints(const char * fileName, uint32_t & restorePointContainers) {
+    Vector::BLF::File file;
+    file.open(fileName, std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+    Vector::BLF::UncompressedFile restorePointsData;
+    restorePointContainers = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file.read()) {
+        auto * restorePointContainer = dynamic_cast<Vector::BLF::RestorePointContainer *>(ohb);
+        if (restorePointContainer != nullptr) {
+            restorePointsData.write(reinterpret_cast<char *>(restorePointContainer->data.data()), restorePointContainer->dataLength);
+            restorePointContainers++;
+        }
+        delete ohb;
+    }
+    file.close();
+    restorePointsData.setFileSize(restorePointsData.tellp());
+    Vector::BLF::RestorePoints restorePoints;
+    if (restorePointContainers > 0)
+        restorePoints.read(restorePointsData);
+    return restorePoints;
+}
+
+/** Test that restore points of an appended file are kept. */
+BOOST_AUTO_TEST_CASE(AppendRestorePoints) {
+    /* write 1500 CanMessages, so there is one restore point */
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 1500; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+
+    /* append 1500 more CanMessages */
+    Vector::BLF::File file2;
+    file2.restorePointInterval = 500;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf", std::ios_base::app);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.restorePointInterval, 1000);
+    for (uint32_t id = 1500; id < 3000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file2.write(canMessage);
+    }
+    file2.close();
+
+    /* one list with the old and the new restore point */
+    uint32_t restorePointContainers;
+    Vector::BLF::RestorePoints restorePoints = readRestorePoints(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf", restorePointContainers);
+    BOOST_CHECK_EQUAL(restorePointContainers, 1);
+    BOOST_CHECK_EQUAL(restorePoints.objectInterval, 1000);
+    BOOST_REQUIRE_EQUAL(restorePoints.restorePoints.size(), 2);
+    Vector::BLF::CompressedFile compressedFile;
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf", std::ios_base::in | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    for (std::size_t i = 0; i < restorePoints.restorePoints.size(); i++) {
+        const Vector::BLF::RestorePoint & restorePoint = restorePoints.restorePoints[i];
+        compressedFile.seekg(static_cast<std::streamoff>(restorePoint.compressedFilePosition), std::ios_base::beg);
+        Vector::BLF::LogContainer logContainer;
+        logContainer.read(compressedFile);
+        BOOST_REQUIRE(compressedFile.good());
+        logContainer.uncompress();
+        BOOST_REQUIRE_LT(restorePoint.uncompressedFileOffset, logContainer.uncompressedFileSize);
+        uint32_t objectId;
+        std::memcpy(&objectId, logContainer.uncompressedFile.data() + restorePoint.uncompressedFileOffset + 32 + 4, sizeof(objectId));
+        BOOST_CHECK_EQUAL(objectId, 1000 + static_cast<uint32_t>(i) * 1001);
+    }
+    compressedFile.close();
+
+    /* append without restore points, so that the file gets shorter */
+    Vector::BLF::File file3;
+    file3.writeRestorePoints = false;
+    file3.open(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf", std::ios_base::app);
+    BOOST_REQUIRE(file3.is_open());
+    file3.close();
+    BOOST_CHECK_EQUAL(file3.fileStatistics.restorePointsOffset, 0);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.objectCount, 3000);
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf"), file3.fileStatistics.fileSize);
+    readRestorePoints(CMAKE_CURRENT_BINARY_DIR "/test_File_AppendRestorePoints.blf", restorePointContainers);
+    BOOST_CHECK_EQUAL(restorePointContainers, 0);
+}
+
+/** Test that checkpoints update the file statistics during write. */
+BOOST_AUTO_TEST_CASE(Checkpoints) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.checkpointSize = 1; // after each LogContainer
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Checkpoints.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 100; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+
+    /* wait until a checkpoint is written, while the file is still open */
+    Vector::BLF::CompressedFile compressedFile;
+    Vector::BLF::FileStatistics fileStatistics;
+    for (int i = 0; (i < 500) && (fileStatistics.objectCount == 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Checkpoints.blf", std::ios_base::in | std::ios_base::binary);
+        BOOST_REQUIRE(compressedFile.is_open());
+        fileStatistics.read(compressedFile);
+        compressedFile.close();
+    }
+
+    /* check file statistics before close */
+    BOOST_CHECK_GT(fileStatistics.fileSize, fileStatistics.statisticsSize);
+    BOOST_CHECK_GT(fileStatistics.objectCount, 0);
+    BOOST_CHECK_LT(fileStatistics.objectCount, 100);
+
+    /* final file statistics */
+    file.close();
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Checkpoints.blf", std::ios_base::in | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    fileStatistics.read(compressedFile);
+    BOOST_CHECK_EQUAL(fileStatistics.objectCount, 100);
+}
+
+/** Test that measurementStartTime and lastObjectTime are set during write. */
+BOOST_AUTO_TEST_CASE(ObjectTimes) {
+    /* measurementStartTime defaults to the current time */
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_ObjectTimes.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    BOOST_CHECK_NE(file.fileStatistics.measurementStartTime.year, 0);
+    file.close();
+
+    /* lastObjectTime is based on the latest object */
+    Vector::BLF::File file2;
+    file2.fileStatistics.measurementStartTime = {2021, 12, 5, 31, 23, 59, 58, 0};
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_ObjectTimes.blf", std::ios_base::out);
+    BOOST_REQUIRE(file2.is_open());
+    auto * canMessage = new Vector::BLF::CanMessage;
+    canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeTenMics;
+    canMessage->objectTimeStamp = 250000; // 2.5 s
+    file2.write(canMessage);
+    canMessage = new Vector::BLF::CanMessage;
+    canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+    canMessage->objectTimeStamp = 1000000000; // 1 s
+    file2.write(canMessage);
+    file2.close();
+
+    /* read back */
+    Vector::BLF::File file3;
+    file3.open(CMAKE_CURRENT_BINARY_DIR "/test_File_ObjectTimes.blf", std::ios_base::in);
+    BOOST_REQUIRE(file3.is_open());
+    BOOST_CHECK_EQUAL(file3.fileStatistics.objectCount, 2);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.measurementStartTime.second, 58);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.lastObjectTime.year, 2022);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.lastObjectTime.month, 1);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.lastObjectTime.day, 1);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.lastObjectTime.dayOfWeek, 6);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.lastObjectTime.second, 0);
+    BOOST_CHECK_EQUAL(file3.fileStatistics.lastObjectTime.milliseconds, 500);
+    file3.close();
+}
+
+/** Write objects in batches. */
+BOOST_AUTO_TEST_CASE(WriteBatch) {
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_WriteBatch.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+
+    /* vector of objects, exceeding the queue size */
+    std::vector<std::unique_ptr<Vector::BLF::ObjectHeaderBase>> objects;
+    for (uint32_t i = 0; i < 100; ++i) {
+        std::unique_ptr<Vector::BLF::CanMessage> canMessage(new Vector::BLF::CanMessage);
+        canMessage->id = i;
+        objects.push_back(std::move(canMessage));
+    }
+    objects.push_back(nullptr); // skipped
+    file.write(std::move(objects));
+    BOOST_CHECK(objects.empty());
+
+    /* array of objects */
+    Vector::BLF::ObjectHeaderBase * ohbs[50];
+    for (uint32_t i = 0; i < 50; ++i) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = 100 + i;
+        ohbs[i] = canMessage;
+    }
+    file.write(ohbs, 50);
+    file.write(ohbs, 0);
+    file.close();
+
+    /* read back in order */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_WriteBatch.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.fileStatistics.objectCount, 150);
+    for (uint32_t i = 0; i < 150; ++i) {
+        Vector::BLF::ObjectHeaderBase * ohb = file2.read();
+        BOOST_REQUIRE(ohb != nullptr);
+        BOOST_REQUIRE(ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE);
+        BOOST_CHECK_EQUAL(static_cast<Vector::BLF::CanMessage *>(ohb)->id, i);
+        delete ohb;
+    }
+
+    /* followed by the restore points, which are just the list header */
+    Vector::BLF::ObjectHeaderBase * ohb = file2.read();
+    BOOST_REQUIRE(ohb != nullptr);
+    BOOST_REQUIRE(ohb->objectType == Vector::BLF::ObjectType::Unknown115);
+    BOOST_CHECK_EQUAL(static_cast<Vector::BLF::RestorePointContainer *>(ohb)->dataLength, 8);
+    delete ohb;
+    BOOST_CHECK(file2.read() == nullptr);
+    file2.close();
+}
+
+/** restore points refer to every 1001st object */
+BOOST_AUTO_TEST_CASE(RestorePoints) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x1000);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RestorePoints.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 5000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        canMessage->objectTimeStamp = id * 1000;
+        file.write(canMessage);
+    }
+    file.close();
+
+    /* collect restore point containers */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RestorePoints.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.fileStatistics.objectCount, 5000);
+    BOOST_CHECK_GT(file2.fileStatistics.restorePointsOffset, 0);
+    Vector::BLF::UncompressedFile restorePointsData;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        auto * restorePointContainer = dynamic_cast<Vector::BLF::RestorePointContainer *>(ohb);
+        if (restorePointContainer != nullptr)
+            restorePointsData.write(reinterpret_cast<char *>(restorePointContainer->data.data()), restorePointContainer->dataLength);
+        delete ohb;
+    }
+    file2.close();
+
+    /* no padding after the restore points */
+    BOOST_CHECK_EQUAL(restorePointsData.tellp(), 8 + 4 * 24);
+    restorePointsData.setFileSize(restorePointsData.tellp());
+    Vector::BLF::RestorePoints restorePoints;
+    restorePoints.read(restorePointsData);
+    BOOST_CHECK_EQUAL(restorePoints.objectInterval, 1000);
+    BOOST_REQUIRE_EQUAL(restorePoints.restorePoints.size(), 4);
+
+    /* each restore point leads to its object */
+    Vector::BLF::CompressedFile compressedFile;
+    compressedFile.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RestorePoints.blf", std::ios_base::in | std::ios_base::binary);
+    BOOST_REQUIRE(compressedFile.is_open());
+    for (std::size_t i = 0; i < restorePoints.restorePoints.size(); i++) {
+        const Vector::BLF::RestorePoint & restorePoint = restorePoints.restorePoints[i];
+        uint32_t id = 1000 + static_cast<uint32_t>(i) * 1001;
+        BOOST_CHECK_EQUAL(restorePoint.timeStamp, id * 1000);
+        compressedFile.seekg(static_cast<std::streamoff>(restorePoint.compressedFilePosition), std::ios_base::beg);
+        Vector::BLF::LogContainer logContainer;
+        logContainer.read(compressedFile);
+        BOOST_REQUIRE(compressedFile.good());
+        logContainer.uncompress();
+        BOOST_REQUIRE_LT(restorePoint.uncompressedFileOffset, logContainer.uncompressedFileSize);
+        uint32_t objectId;
+        std::memcpy(&objectId, logContainer.uncompressedFile.data() + restorePoint.uncompressedFileOffset + 32 + 4, sizeof(objectId));
+        BOOST_CHECK_EQUAL(objectId, id);
+    }
+    compressedFile.close();
+}
+
+/** partial log containers are written after the flush latency */
+BOOST_AUTO_TEST_CASE(MaxFlushLatency) {
+    Vector::BLF::File file;
+    BOOST_CHECK_EQUAL(file.maxFlushLatency().count(), 0);
+    file.setMaxFlushLatency(std::chrono::milliseconds(20));
+    BOOST_CHECK_EQUAL(file.maxFlushLatency().count(), 20);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_MaxFlushLatency.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    file.write(new Vector::BLF::CanMessage);
+    file.write(new Vector::BLF::CanMessage);
+
+    /* wait until the log container is on disk, while the file is still open */
+    std::ifstream ifs;
+    char signature[4] = {};
+    for (int i = 0; (i < 500) && (std::memcmp(signature, "LOBJ", 4) != 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ifs.open(CMAKE_CURRENT_BINARY_DIR "/test_File_MaxFlushLatency.blf", std::ios_base::in | std::ios_base::binary);
+        ifs.seekg(file.fileStatistics.statisticsSize);
+        ifs.read(signature, sizeof(signature));
+        ifs.close();
+        ifs.clear();
+    }
+    BOOST_CHECK(std::memcmp(signature, "LOBJ", 4) == 0);
+
+    /* a later object goes into a new log container */
+    file.write(new Vector::BLF::CanMessage);
+    file.close();
+
+    /* read back */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_MaxFlushLatency.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_EQUAL(file2.fileStatistics.objectCount, 3);
+    uint32_t canMessages = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        if (ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE)
+            canMessages++;
+        delete ohb;
+    }
+    BOOST_CHECK_EQUAL(canMessages, 3);
+    file2.close();
+}
+
+/** follow a file, that is still being written */
+BOOST_AUTO_TEST_CASE(Follow) {
+    /* write file */
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Follow_Complete.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 100; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+    std::ifstream ifs(CMAKE_CURRENT_BINARY_DIR "/test_File_Follow_Complete.blf", std::ios_base::in | std::ios_base::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+
+    /* first half, that ends within a log container */
+    std::size_t half = data.size() / 2;
+    std::ofstream ofs(CMAKE_CURRENT_BINARY_DIR "/test_File_Follow.blf", std::ios_base::out | std::ios_base::binary);
+    ofs.write(data.data(), static_cast<std::streamsize>(half));
+    ofs.close();
+
+    /* read objects up to the incomplete log container */
+    Vector::BLF::File file2;
+    file2.follow = true;
+    file2.followPollInterval = std::chrono::milliseconds(10);
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Follow.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    uint32_t id = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read(std::chrono::milliseconds(500))) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        BOOST_CHECK_EQUAL(canMessage->id, id);
+        id++;
+        delete ohb;
+    }
+    BOOST_CHECK(file2.good());
+    BOOST_CHECK_GT(id, 0);
+    BOOST_CHECK_LT(id, 100);
+
+    /* second half */
+    ofs.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Follow.blf", std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+    ofs.write(data.data() + half, static_cast<std::streamsize>(data.size() - half));
+    ofs.close();
+    while (id < 100) {
+        Vector::BLF::ObjectHeaderBase * ohb = file2.read(std::chrono::seconds(5));
+        BOOST_REQUIRE(ohb != nullptr);
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        BOOST_CHECK_EQUAL(canMessage->id, id);
+        id++;
+        delete ohb;
+    }
+
+    /* no eof at the end of the file */
+    BOOST_CHECK(file2.read(std::chrono::milliseconds(100)) == nullptr);
+    BOOST_CHECK(file2.good());
+    file2.close();
+}
+
+/** recover objects from a file with corrupted object and log container headers */
+BOOST_AUTO_TEST_CASE(RecoverCorruption) {
+    /* write file with uncompressed LogContainers */
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.compressionLevel = 0;
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverCorruption.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 100; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+
+    /* an intact file doesn't skip anything */
+    Vector::BLF::File file2;
+    file2.recoverCorruption = true;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverCorruption.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    uint32_t objectCount = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        objectCount++;
+        delete ohb;
+    }
+    file2.close();
+    BOOST_CHECK_EQUAL(objectCount, 100);
+    BOOST_CHECK(file2.skippedRanges().empty());
+
+    /* find the object signatures */
+    std::fstream fs(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverCorruption.blf", std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    BOOST_REQUIRE(fs.is_open());
+    std::vector<char> data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    std::vector<std::streamoff> logContainers;
+    std::vector<std::streamoff> canMessages;
+    for (std::size_t i = 0; i + 16 <= data.size(); i++) {
+        if (std::memcmp(&data[i], "LOBJ", 4) != 0)
+            continue;
+        uint32_t objectType;
+        std::memcpy(&objectType, &data[i + 12], sizeof(objectType));
+        if (objectType == static_cast<uint32_t>(Vector::BLF::ObjectType::LOG_CONTAINER))
+            logContainers.push_back(i);
+        if (objectType == static_cast<uint32_t>(Vector::BLF::ObjectType::CAN_MESSAGE))
+            canMessages.push_back(i);
+    }
+    BOOST_REQUIRE_GT(logContainers.size(), 10);
+    BOOST_REQUIRE_GT(canMessages.size(), 10);
+
+    /* corrupt an object signature and a log container signature */
+    fs.clear();
+    fs.seekp(canMessages[10]);
+    fs.write("XXXX", 4);
+    fs.seekp(logContainers[logContainers.size() / 2]);
+    fs.write("XXXX", 4);
+    fs.close();
+
+    /* read in recovery mode */
+    Vector::BLF::File file3;
+    file3.recoverCorruption = true;
+    file3.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverCorruption.blf", std::ios_base::in);
+    BOOST_REQUIRE(file3.is_open());
+    objectCount = 0;
+    uint32_t lastId = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file3.read()) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        if (objectCount > 0)
+            BOOST_CHECK_GT(canMessage->id, lastId);
+        lastId = canMessage->id;
+        objectCount++;
+        delete ohb;
+    }
+    file3.close();
+    BOOST_CHECK_GT(objectCount, 80);
+    BOOST_CHECK_LT(objectCount, 99);
+    BOOST_CHECK_EQUAL(lastId, 99);
+
+    /* both levels are reported */
+    std::vector<Vector::BLF::SkippedRange> skippedRanges = file3.skippedRanges();
+    BOOST_CHECK_GE(skippedRanges.size(), 2);
+    bool compressed = false;
+    bool uncompressed = false;
+    for (const Vector::BLF::SkippedRange & skippedRange : skippedRanges) {
+        BOOST_CHECK_GT(skippedRange.size, 0);
+        if (skippedRange.level == Vector::BLF::SkippedRange::Compressed)
+            compressed = true;
+        if (skippedRange.level == Vector::BLF::SkippedRange::Uncompressed)
+            uncompressed = true;
+    }
+    BOOST_CHECK(compressed);
+    BOOST_CHECK(uncompressed);
+}
+
+/** objects larger than the uncompressed buffer */
+BOOST_AUTO_TEST_CASE(ReadLargeObjects) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_ReadLargeObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    auto * eventComment = new Vector::BLF::EventComment;
+    eventComment->text = std::string(0x30000, 'x');
+    file.write(eventComment);
+    file.write(new Vector::BLF::CanMessage);
+    file.close();
+
+    /* read */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_ReadLargeObjects.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    Vector::BLF::ObjectHeaderBase * ohb = file2.read();
+    BOOST_REQUIRE(ohb != nullptr);
+    BOOST_REQUIRE(ohb->objectType == Vector::BLF::ObjectType::EVENT_COMMENT);
+    BOOST_CHECK_EQUAL(static_cast<Vector::BLF::EventComment *>(ohb)->text.size(), 0x30000);
+    delete ohb;
+    ohb = file2.read();
+    BOOST_REQUIRE(ohb != nullptr);
+    BOOST_CHECK(ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE);
+    delete ohb;
+    BOOST_CHECK(file2.read() == nullptr);
+    file2.close();
+}
+
+/** objects larger than a LogContainer are not taken as corruption */
+BOOST_AUTO_TEST_CASE(RecoverLargeObjects) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverLargeObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    auto * eventComment = new Vector::BLF::EventComment;
+    eventComment->text = std::string(0x30000, 'x');
+    file.write(eventComment);
+    file.write(new Vector::BLF::CanMessage);
+    file.close();
+
+    /* read in recovery mode */
+    Vector::BLF::File file2;
+    file2.recoverCorruption = true;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverLargeObjects.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    BOOST_CHECK_LT(file2.defaultLogContainerSize(), 0x30000);
+    Vector::BLF::ObjectHeaderBase * ohb = file2.read();
+    BOOST_REQUIRE(ohb != nullptr);
+    BOOST_REQUIRE(ohb->objectType == Vector::BLF::ObjectType::EVENT_COMMENT);
+    BOOST_CHECK_EQUAL(static_cast<Vector::BLF::EventComment *>(ohb)->text.size(), 0x30000);
+    delete ohb;
+    ohb = file2.read();
+    BOOST_REQUIRE(ohb != nullptr);
+    BOOST_CHECK(ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE);
+    delete ohb;
+    BOOST_CHECK(file2.read() == nullptr);
+    file2.close();
+    BOOST_CHECK(file2.skippedRanges().empty());
+}
+
+/** padded objects of a clean file are read in recovery mode without resynchronization */
+BOOST_AUTO_TEST_CASE(RecoverPaddedObjects) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverPaddedObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t i = 0; i < 100; i++) {
+        auto * eventComment = new Vector::BLF::EventComment;
+        eventComment->text = std::string(i % 7, 'x');
+        file.write(eventComment);
+    }
+    file.close();
+
+    /* read in recovery mode */
+    Vector::BLF::File file2;
+    file2.recoverCorruption = true;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_RecoverPaddedObjects.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    uint32_t objectCount = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        if (ohb->objectType == Vector::BLF::ObjectType::EVENT_COMMENT) {
+            BOOST_CHECK_EQUAL(static_cast<Vector::BLF::EventComment *>(ohb)->text.size(), objectCount % 7);
+            objectCount++;
+        }
+        delete ohb;
+    }
+    file2.close();
+    BOOST_CHECK_EQUAL(objectCount, 100);
+    BOOST_CHECK(file2.skippedRanges().empty());
+    BOOST_CHECK_EQUAL(file2.resyncCount(), 0);
+}
+
+/** progress during read */
+BOOST_AUTO_TEST_CASE(Progress) {
+    /* write file */
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x1000);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Progress.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 10000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        canMessage->objectTimeStamp = (id + 1) * 1000;
+        file.write(canMessage);
+    }
+    file.close();
+
+    /* read file */
+    Vector::BLF::File file2;
+    std::vector<Vector::BLF::Progress> progresses;
+    file2.progressInterval = std::chrono::milliseconds(0);
+    file2.progressCallback = [&progresses](const Vector::BLF::Progress & progress) {
+        progresses.push_back(progress);
+    };
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_File_Progress.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    uint32_t objectCount = 0;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+        if (ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE)
+            objectCount++;
+        delete ohb;
+    }
+    file2.close();
+    BOOST_CHECK_EQUAL(objectCount, 10000);
+
+    /* callbacks */
+    BOOST_REQUIRE_GT(progresses.size(), 10);
+    for (std::size_t i = 1; i < progresses.size(); i++) {
+        BOOST_CHECK_GE(progresses[i].compressedBytesRead, progresses[i - 1].compressedBytesRead);
+        BOOST_CHECK_GE(progresses[i].logContainersRead, progresses[i - 1].logContainersRead);
+    }
+    BOOST_CHECK_EQUAL(progresses.back().compressedBytesRead, file2.fileStatistics.fileSize);
+    BOOST_CHECK_EQUAL(progresses.back().compressedFileSize, file2.fileStatistics.fileSize);
+
+    /* snapshot */
+    Vector::BLF::Progress progress = file2.progress();
+    BOOST_CHECK_EQUAL(progress.compressedBytesRead, file2.fileStatistics.fileSize);
+    BOOST_CHECK_EQUAL(progress.logContainersRead, progresses.back().logContainersRead);
+    BOOST_CHECK_EQUAL(progress.objectsRead, 10000);
+    BOOST_CHECK_EQUAL(progress.objectTimeStamp, 10000 * 1000);
+}
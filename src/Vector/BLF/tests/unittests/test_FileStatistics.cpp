@@ -35,3 +35,32 @@ BOOST_AUTO_TEST_CASE(WrongFileSignature) {
     Vector::BLF::FileStatistics fileStatistics2;
     BOOST_CHECK_THROW(fileStatistics2.read(file), Vector::BLF::Exception);
 }
+
+/** test conversion between system time and nanoseconds */
+BOOST_AUTO_TEST_CASE(SystemTimeConversion) {
+    Vector::BLF::SYSTEMTIME systemTime1 = {2020, 2, 6, 29, 23, 59, 58, 999};
+    int64_t ns = Vector::BLF::systemTimeToNs(systemTime1);
+    BOOST_CHECK_EQUAL(ns, INT64_C(1583020798999000000));
+
+    /* 1.002 seconds later it is Sunday, 2020-03-01 */
+    Vector::BLF::SYSTEMTIME systemTime2 = Vector::BLF::nsToSystemTime(ns + 1002000000);
+    BOOST_CHECK_EQUAL(systemTime2.year, 2020);
+    BOOST_CHECK_EQUAL(systemTime2.month, 3);
+    BOOST_CHECK_EQUAL(systemTime2.dayOfWeek, 0);
+    BOOST_CHECK_EQUAL(systemTime2.day, 1);
+    BOOST_CHECK_EQUAL(systemTime2.hour, 0);
+    BOOST_CHECK_EQUAL(systemTime2.minute, 0);
+    BOOST_CHECK_EQUAL(systemTime2.second, 0);
+    BOOST_CHECK_EQUAL(systemTime2.milliseconds, 1);
+
+    /* round trip */
+    Vector::BLF::SYSTEMTIME systemTime3 = Vector::BLF::nsToSystemTime(ns);
+    BOOST_CHECK_EQUAL(systemTime3.dayOfWeek, 6);
+    BOOST_CHECK_EQUAL(Vector::BLF::systemTimeToNs(systemTime3), ns);
+
+    /* current time */
+    Vector::BLF::SYSTEMTIME systemTime4 = Vector::BLF::currentSystemTime();
+    BOOST_CHECK_GE(systemTime4.year, 2021);
+    BOOST_CHECK_GE(systemTime4.month, 1);
+    BOOST_CHECK_LE(systemTime4.month, 12);
+}
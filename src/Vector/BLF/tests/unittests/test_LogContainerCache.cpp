@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE LogContainerCache
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include <Vector/BLF.h>
+
+/**
+ * Create an uncompressed LogContainer.
+ *
+ * @param[in] size uncompressed size
+ * @return LogContainer
+ */
+static Vector::BLF::LogContainer logContainer(uint32_t size) {
+    Vector::BLF::LogContainer logContainer;
+    logContainer.objectSize = size + 32;
+    logContainer.uncompressedFile.resize(size, static_cast<uint8_t>(size));
+    logContainer.uncompressedFileSize = size;
+    return logContainer;
+}
+
+/** identity of the file, that the LogContainers belong to */
+static const Vector::BLF::LogContainerCache::FileIdentity fileIdentity {};
+
+/** least recently used LogContainers are dropped */
+BOOST_AUTO_TEST_CASE(LeastRecentlyUsed) {
+    Vector::BLF::LogContainerCache cache(0x300);
+    cache.put(fileIdentity, 0x000, logContainer(0x100));
+    cache.put(fileIdentity, 0x100, logContainer(0x100));
+    cache.put(fileIdentity, 0x200, logContainer(0x100));
+    BOOST_CHECK_EQUAL(cache.size(), 0x300);
+
+    /* use first one, so second one is dropped */
+    BOOST_CHECK(cache.get(fileIdentity, 0x000, 0x120));
+    cache.put(fileIdentity, 0x300, logContainer(0x100));
+    BOOST_CHECK_EQUAL(cache.size(), 0x300);
+    BOOST_CHECK(cache.get(fileIdentity, 0x000, 0x120));
+    BOOST_CHECK(!cache.get(fileIdentity, 0x100, 0x120));
+    BOOST_CHECK(cache.get(fileIdentity, 0x200, 0x120));
+    std::shared_ptr<const Vector::BLF::LogContainer> cached = cache.get(fileIdentity, 0x300, 0x120);
+    BOOST_REQUIRE(cached);
+    BOOST_CHECK_EQUAL(cached->uncompressedFileSize, 0x100);
+    BOOST_CHECK_EQUAL(cached->uncompressedFile.size(), 0x100);
+    BOOST_CHECK_EQUAL(cache.hits(), 4);
+    BOOST_CHECK_EQUAL(cache.misses(), 1);
+
+    /* different objectSize is a miss */
+    BOOST_CHECK(!cache.get(fileIdentity, 0x000, 0x220));
+
+    /* different file identity is a miss */
+    Vector::BLF::LogContainerCache::FileIdentity otherFileIdentity;
+    otherFileIdentity.modificationTime = 1;
+    BOOST_CHECK(!cache.get(otherFileIdentity, 0x000, 0x120));
+
+    /* shrink */
+    cache.setMaxSize(0x100);
+    BOOST_CHECK_EQUAL(cache.size(), 0x100);
+    BOOST_CHECK(cache.get(fileIdentity, 0x300, 0x120));
+
+    /* too large */
+    cache.put(fileIdentity, 0x400, logContainer(0x200));
+    BOOST_CHECK(!cache.get(fileIdentity, 0x400, 0x220));
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK(!cache.get(fileIdentity, 0x300, 0x120));
+}
+
+/** caches are shared per path, as long as they are used */
+BOOST_AUTO_TEST_CASE(ForPath) {
+    std::shared_ptr<Vector::BLF::LogContainerCache> cache1 = Vector::BLF::LogContainerCache::forPath("a.blf");
+    std::shared_ptr<Vector::BLF::LogContainerCache> cache2 = Vector::BLF::LogContainerCache::forPath("a.blf");
+    std::shared_ptr<Vector::BLF::LogContainerCache> cache3 = Vector::BLF::LogContainerCache::forPath("b.blf");
+    BOOST_CHECK(cache1 == cache2);
+    BOOST_CHECK(cache1 != cache3);
+    cache1->put(fileIdentity, 0, logContainer(0x100));
+    cache1.reset();
+    BOOST_CHECK(cache2->get(fileIdentity, 0, 0x120));
+    cache2.reset();
+
+    /* new cache after all users released it */
+    cache1 = Vector::BLF::LogContainerCache::forPath("a.blf");
+    BOOST_CHECK(!cache1->get(fileIdentity, 0, 0x120));
+}
+
+/** files on the same path share the uncompressed LogContainers */
+BOOST_AUTO_TEST_CASE(SharedByFiles) {
+    /* write file */
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x1000);
+    file.writeRestorePoints = false;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_LogContainerCache_SharedByFiles.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 1000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+
+    /* read file twice, while the cache is in use */
+    std::shared_ptr<Vector::BLF::LogContainerCache> cache = Vector::BLF::LogContainerCache::forPath(CMAKE_CURRENT_BINARY_DIR "/test_LogContainerCache_SharedByFiles.blf");
+    for (uint64_t pass = 0; pass < 2; pass++) {
+        Vector::BLF::File file2;
+        file2.logContainerCache = Vector::BLF::LogContainerCache::forPath(CMAKE_CURRENT_BINARY_DIR "/test_LogContainerCache_SharedByFiles.blf");
+        file2.open(CMAKE_CURRENT_BINARY_DIR "/test_LogContainerCache_SharedByFiles.blf", std::ios_base::in);
+        BOOST_REQUIRE(file2.is_open());
+        uint32_t id = 0;
+        while (Vector::BLF::ObjectHeaderBase * ohb = file2.read()) {
+            auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+            BOOST_REQUIRE(canMessage != nullptr);
+            BOOST_CHECK_EQUAL(canMessage->id, id);
+            id++;
+            delete ohb;
+        }
+        BOOST_CHECK_EQUAL(id, 1000);
+
+        /* 1000 CAN messages of 48 bytes are 12 LogContainers */
+        BOOST_CHECK(file2.logContainerCache == cache);
+        BOOST_CHECK_EQUAL(cache->hits(), pass * 12);
+        BOOST_CHECK_EQUAL(cache->misses(), 12);
+        file2.close();
+    }
+}
+
+/**
+ * Write CAN messages.
+ *
+ * @param[in] fileName file name
+ * @param[in] firstId id of first CAN message
+ */
+static void writeCanMessages(const std::string & fileName, uint32_t firstId) {
+    Vector::BLF::File file;
+    file.compressionLevel = 0;
+    file.setDefaultLogContainerSize(0x1000);
+    file.writeRestorePoints = false;
+    file.open(fileName, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = firstId; id < firstId + 1000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+    }
+    file.close();
+}
+
+/** a file, that was written again with the same LogContainer sizes, is not taken from the cache */
+BOOST_AUTO_TEST_CASE(RewrittenFile) {
+    const std::string fileName = CMAKE_CURRENT_BINARY_DIR "/test_LogContainerCache_RewrittenFile.blf";
+    std::shared_ptr<Vector::BLF::LogContainerCache> cache = Vector::BLF::LogContainerCache::forPath(fileName);
+    for (uint32_t firstId = 0; firstId < 2000; firstId += 1000) {
+        writeCanMessages(fileName, firstId);
+
+        Vector::BLF::File file;
+        file.logContainerCache = cache;
+        file.open(fileName, std::ios_base::in);
+        BOOST_REQUIRE(file.is_open());
+        uint32_t id = firstId;
+        while (Vector::BLF::ObjectHeaderBase * ohb = file.read()) {
+            auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+            BOOST_REQUIRE(canMessage != nullptr);
+            BOOST_CHECK_EQUAL(canMessage->id, id);
+            id++;
+            delete ohb;
+        }
+        BOOST_CHECK_EQUAL(id, firstId + 1000);
+        file.close();
+    }
+    BOOST_CHECK_EQUAL(cache->hits(), 0);
+}
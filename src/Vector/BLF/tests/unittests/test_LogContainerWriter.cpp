@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE LogContainerWriter
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <Vector/BLF.h>
+
+/** Write over LogContainer boundaries and seal the last one. */
+BOOST_AUTO_TEST_CASE(WriteSeal) {
+    Vector::BLF::UncompressedFile uncompressedFile;
+    uncompressedFile.setDefaultLogContainerSize(4);
+    uncompressedFile.setBufferSize(16);
+    Vector::BLF::LogContainerWriter logContainerWriter(uncompressedFile);
+
+    /* after initialization */
+    BOOST_CHECK_EQUAL(logContainerWriter.tellp(), 0);
+    BOOST_CHECK(logContainerWriter.good());
+    BOOST_CHECK(!logContainerWriter.eof());
+
+    /* full log containers are handed over */
+    logContainerWriter.write("abcdefghij", 10);
+    BOOST_CHECK_EQUAL(logContainerWriter.tellp(), 10);
+    BOOST_CHECK_EQUAL(uncompressedFile.tellp(), 8);
+
+    /* the last log container is handed over with seal */
+    logContainerWriter.seal();
+    BOOST_CHECK_EQUAL(logContainerWriter.tellp(), 10);
+    BOOST_CHECK_EQUAL(uncompressedFile.tellp(), 10);
+    uncompressedFile.setFileSize(uncompressedFile.tellp());
+
+    /* sealing again doesn't create empty log containers */
+    logContainerWriter.seal();
+    BOOST_CHECK_EQUAL(uncompressedFile.tellp(), 10);
+
+    /* read log containers */
+    std::shared_ptr<Vector::BLF::LogContainer> logContainer = uncompressedFile.readLogContainer();
+    BOOST_CHECK_EQUAL(logContainer->uncompressedFileSize, 4);
+    BOOST_CHECK_EQUAL(logContainer->uncompressedFile[0], 'a');
+    logContainer = uncompressedFile.readLogContainer();
+    BOOST_CHECK_EQUAL(logContainer->uncompressedFileSize, 4);
+    BOOST_CHECK_EQUAL(logContainer->uncompressedFile[0], 'e');
+    logContainer = uncompressedFile.readLogContainer();
+    BOOST_CHECK_EQUAL(logContainer->uncompressedFileSize, 2);
+    BOOST_CHECK_EQUAL(logContainer->uncompressedFile[1], 'j');
+}
+
+/** Reading is not supported. */
+BOOST_AUTO_TEST_CASE(Read) {
+    Vector::BLF::UncompressedFile uncompressedFile;
+    Vector::BLF::LogContainerWriter logContainerWriter(uncompressedFile);
+
+    char s[2];
+    logContainerWriter.read(s, sizeof(s));
+    BOOST_CHECK_EQUAL(logContainerWriter.gcount(), 0);
+    BOOST_CHECK_EQUAL(logContainerWriter.tellg(), -1);
+    BOOST_CHECK(!logContainerWriter.good());
+}
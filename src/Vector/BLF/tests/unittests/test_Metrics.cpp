@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE Metrics
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+#include <Vector/BLF.h>
+
+/** counters of a stage */
+BOOST_AUTO_TEST_CASE(StageCounters) {
+    Vector::BLF::StageCounters stageCounters;
+    stageCounters.add(100, std::chrono::microseconds(2));
+    stageCounters.add(50, std::chrono::microseconds(3));
+    Vector::BLF::StageMetrics stageMetrics = stageCounters.metrics();
+    BOOST_CHECK_EQUAL(stageMetrics.count, 2);
+    BOOST_CHECK_EQUAL(stageMetrics.bytes, 150);
+    BOOST_CHECK(stageMetrics.time == std::chrono::microseconds(5));
+}
+
+/** metrics of a read file */
+BOOST_AUTO_TEST_CASE(FileMetrics) {
+    /* write file */
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x1000);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_Metrics_FileMetrics.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 1000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+        if (id % 10 == 9) {
+            auto * canFdMessage64 = new Vector::BLF::CanFdMessage64;
+            canFdMessage64->id = id;
+            file.write(canFdMessage64);
+        }
+    }
+    file.close();
+
+    /* read file */
+    Vector::BLF::File file2;
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_Metrics_FileMetrics.blf", std::ios_base::in);
+    BOOST_REQUIRE(file2.is_open());
+    while (Vector::BLF::ObjectHeaderBase * ohb = file2.read())
+        delete ohb;
+    file2.close();
+    Vector::BLF::Metrics metrics = file2.metrics();
+
+    /* without OPTION_USE_METRICS nothing is collected */
+    if (!metrics.enabled) {
+        BOOST_CHECK_EQUAL(metrics.compressedFileRead.count, 0);
+        BOOST_CHECK_EQUAL(metrics.inflate.count, 0);
+        BOOST_CHECK(metrics.decode.empty());
+        BOOST_CHECK_EQUAL(metrics.objectQueue.highWaterMark, 0);
+        return;
+    }
+
+    /* disk I/O and inflate */
+    BOOST_CHECK_GE(metrics.compressedFileRead.bytes, file2.fileStatistics.fileSize);
+    BOOST_CHECK_GT(metrics.inflate.count, 10);
+    BOOST_CHECK_GT(metrics.inflate.bytes, 0);
+    BOOST_CHECK_GT(metrics.inflate.time.count(), 0);
+
+    /* decode */
+    BOOST_CHECK_EQUAL(metrics.decode[Vector::BLF::ObjectType::CAN_MESSAGE].count, 1000);
+    BOOST_CHECK_EQUAL(metrics.decode[Vector::BLF::ObjectType::CAN_FD_MESSAGE_64].count, 100);
+    BOOST_CHECK_GT(metrics.decode[Vector::BLF::ObjectType::CAN_MESSAGE].bytes, 0);
+
+    /* queues */
+    BOOST_CHECK_GT(metrics.uncompressedFile.highWaterMark, 0);
+    BOOST_CHECK_GT(metrics.objectQueue.highWaterMark, 0);
+    BOOST_CHECK_LE(metrics.objectQueue.highWaterMark, 10);
+}
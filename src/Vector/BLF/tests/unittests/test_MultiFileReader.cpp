@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE MultiFileReader
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/**
+ * Write a file with CAN messages.
+ *
+ * @param[in] filename file name
+ * @param[in] channel channel of all messages
+ * @param[in] timeStamps timestamps in nanoseconds
+ */
+static void writeFile(const char * filename, uint16_t channel, const std::vector<uint64_t> & timeStamps) {
+    Vector::BLF::File file;
+    file.fileStatistics.measurementStartTime = {2021, 12, 5, 31, 23, 59, 58, 0};
+    file.open(filename, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint64_t timeStamp : timeStamps) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->channel = channel;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        canMessage->objectTimeStamp = timeStamp;
+        file.write(canMessage);
+    }
+    file.close();
+}
+
+/** merge files by object timestamp */
+BOOST_AUTO_TEST_CASE(MergeByTimeStamp) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_1.blf", 1, {0, 30, 60, 90});
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_2.blf", 2, {10, 30, 70});
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_3.blf", 3, {});
+
+    Vector::BLF::MultiFileReader reader;
+    reader.open({
+        CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_1.blf",
+        CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_2.blf",
+        CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_3.blf"
+    });
+    BOOST_REQUIRE(reader.is_open());
+    BOOST_CHECK_EQUAL(reader.size(), 3);
+
+    std::vector<uint64_t> timeStamps;
+    std::vector<std::size_t> sources;
+    std::size_t source;
+    while (Vector::BLF::ObjectHeaderBase * ohb = reader.read(source)) {
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        BOOST_CHECK_EQUAL(canMessage->channel, source + 1);
+        timeStamps.push_back(canMessage->objectTimeStamp);
+        sources.push_back(source);
+        delete ohb;
+    }
+    reader.close();
+
+    /* equal timestamps are returned in file order */
+    std::vector<uint64_t> expectedTimeStamps {0, 10, 30, 30, 60, 70, 90};
+    std::vector<std::size_t> expectedSources {0, 1, 0, 1, 0, 1, 0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(timeStamps.begin(), timeStamps.end(), expectedTimeStamps.begin(), expectedTimeStamps.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(sources.begin(), sources.end(), expectedSources.begin(), expectedSources.end());
+}
+
+/** timestamps are normalized to nanoseconds and the earliest measurementStartTime */
+BOOST_AUTO_TEST_CASE(NormalizedTimeStamps) {
+    /* starts 1s later, timestamps in 10us */
+    Vector::BLF::File file;
+    file.fileStatistics.measurementStartTime = {2021, 12, 5, 31, 23, 59, 59, 0};
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_4.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    auto * canMessage = new Vector::BLF::CanMessage;
+    canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeTenMics;
+    canMessage->objectTimeStamp = 10; // 1s + 100us
+    file.write(canMessage);
+    file.close();
+
+    /* starts first, timestamps in ns */
+    Vector::BLF::File file2;
+    file2.fileStatistics.measurementStartTime = {2021, 12, 5, 31, 23, 59, 58, 0};
+    file2.open(CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_5.blf", std::ios_base::out);
+    BOOST_REQUIRE(file2.is_open());
+    for (uint64_t timeStamp : {1000000000, 1000200000}) {
+        canMessage = new Vector::BLF::CanMessage;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        canMessage->objectTimeStamp = timeStamp;
+        file2.write(canMessage);
+    }
+    file2.close();
+
+    Vector::BLF::MultiFileReader reader;
+    reader.open({
+        CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_4.blf",
+        CMAKE_CURRENT_BINARY_DIR "/test_MultiFileReader_5.blf"
+    });
+    BOOST_REQUIRE(reader.is_open());
+    BOOST_CHECK_EQUAL(reader.timeStampOffset(0), 1000000000);
+    BOOST_CHECK_EQUAL(reader.timeStampOffset(1), 0);
+
+    std::vector<std::size_t> sources;
+    std::size_t source;
+    while (Vector::BLF::ObjectHeaderBase * ohb = reader.read(source)) {
+        sources.push_back(source);
+        delete ohb;
+    }
+    std::vector<std::size_t> expectedSources {1, 0, 1};
+    BOOST_CHECK_EQUAL_COLLECTIONS(sources.begin(), sources.end(), expectedSources.begin(), expectedSources.end());
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE ObjectDispatch
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <type_traits>
+
+#include <Vector/BLF.h>
+
+/** visitor that returns the channel of CAN messages and 0 for all other objects */
+struct CanChannelVisitor {
+    uint16_t operator()(const Vector::BLF::CanMessage & canMessage) const {
+        return canMessage.channel;
+    }
+
+    template <typename T>
+    uint16_t operator()(const T &) const {
+        return 0;
+    }
+};
+
+/** visitor that returns the object size calculated by the concrete class */
+struct ObjectSizeVisitor {
+    template <typename T>
+    uint32_t operator()(T & obj) const {
+        return obj.T::calculateObjectSize();
+    }
+};
+
+/** check the compile-time type mapping */
+BOOST_AUTO_TEST_CASE(ObjectClass) {
+    BOOST_CHECK((std::is_same<Vector::BLF::ObjectClass<Vector::BLF::ObjectType::CAN_MESSAGE>::type, Vector::BLF::CanMessage>::value));
+    BOOST_CHECK((std::is_same<Vector::BLF::ObjectClass<Vector::BLF::ObjectType::CAN_FD_MESSAGE_64>::type, Vector::BLF::CanFdMessage64>::value));
+    BOOST_CHECK((std::is_same<Vector::BLF::ObjectClass<Vector::BLF::ObjectType::ENV_DATA>::type, Vector::BLF::EnvironmentVariable>::value));
+    BOOST_CHECK((std::is_same<Vector::BLF::ObjectClass<Vector::BLF::ObjectType::Reserved26>::type, Vector::BLF::ObjectHeaderBase>::value));
+    BOOST_CHECK(Vector::BLF::ObjectClass<Vector::BLF::ObjectType::CAN_MESSAGE>::value);
+    BOOST_CHECK(!Vector::BLF::ObjectClass<Vector::BLF::ObjectType::UNKNOWN>::value);
+
+    static_assert(Vector::BLF::isSupportedObjectType(Vector::BLF::ObjectType::LOG_CONTAINER), "LOG_CONTAINER is supported");
+    static_assert(!Vector::BLF::isSupportedObjectType(Vector::BLF::ObjectType::Reserved116), "Reserved116 is not supported");
+}
+
+/** all supported object types can be created and dispatched to their class */
+BOOST_AUTO_TEST_CASE(SupportedObjectTypes) {
+    for (Vector::BLF::ObjectType objectType : Vector::BLF::SupportedObjectTypes) {
+        Vector::BLF::ObjectHeaderBase * ohb = Vector::BLF::File::createObject(objectType);
+        BOOST_REQUIRE(ohb != nullptr);
+        ohb->objectType = objectType; // EnvironmentVariable is created with UNKNOWN
+        BOOST_CHECK_EQUAL(Vector::BLF::dispatch(*ohb, ObjectSizeVisitor()), ohb->calculateObjectSize());
+        delete ohb;
+    }
+}
+
+/** dispatch calls the overload for the concrete class */
+BOOST_AUTO_TEST_CASE(Dispatch) {
+    Vector::BLF::CanMessage canMessage;
+    canMessage.channel = 3;
+    const Vector::BLF::ObjectHeaderBase & ohb1 = canMessage;
+    BOOST_CHECK_EQUAL(Vector::BLF::dispatch(ohb1, CanChannelVisitor()), 3);
+
+    Vector::BLF::CanMessage2 canMessage2;
+    canMessage2.channel = 4;
+    const Vector::BLF::ObjectHeaderBase & ohb2 = canMessage2;
+    BOOST_CHECK_EQUAL(Vector::BLF::dispatch(ohb2, CanChannelVisitor()), 0);
+
+    /* unsupported types are passed as ObjectHeaderBase */
+    Vector::BLF::ObjectHeaderBase ohb3(1, Vector::BLF::ObjectType::Reserved52);
+    BOOST_CHECK_EQUAL(Vector::BLF::dispatch(ohb3, ObjectSizeVisitor()), ohb3.calculateObjectSize());
+}
+
+/** object timestamps are converted into nanoseconds */
+BOOST_AUTO_TEST_CASE(ObjectTimeStampNs) {
+    Vector::BLF::CanMessage canMessage;
+    canMessage.objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+    canMessage.objectTimeStamp = 1234;
+    BOOST_CHECK_EQUAL(Vector::BLF::objectTimeStampNs(canMessage), 1234);
+    canMessage.objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeTenMics;
+    BOOST_CHECK_EQUAL(Vector::BLF::objectTimeStampNs(canMessage), 12340000);
+
+    /* object with multiple base classes */
+    Vector::BLF::CanFdMessage64 canFdMessage64;
+    canFdMessage64.objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeTenMics;
+    canFdMessage64.objectTimeStamp = 5;
+    BOOST_CHECK_EQUAL(Vector::BLF::objectTimeStampNs(canFdMessage64), 50000);
+
+    /* objects without timestamp */
+    Vector::BLF::LogContainer logContainer;
+    BOOST_CHECK_EQUAL(Vector::BLF::objectTimeStampNs(logContainer), 0);
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE ObjectRange
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/**
+ * Write a file with 1000 CanMessages, and a CanFdMessage64 after every
+ * tenth of them.
+ *
+ * @param[in] fileName file name
+ */
+static void writeFile(const char * fileName) {
+    Vector::BLF::File file;
+    file.writeRestorePoints = false;
+    file.open(fileName, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t id = 0; id < 1000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        file.write(canMessage);
+        if (id % 10 == 9) {
+            auto * canFdMessage64 = new Vector::BLF::CanFdMessage64;
+            canFdMessage64->id = id;
+            file.write(canFdMessage64);
+        }
+    }
+    file.close();
+}
+
+/** object classes of object types */
+BOOST_AUTO_TEST_CASE(InstanceOf) {
+    static_assert(Vector::BLF::isInstanceOf<Vector::BLF::CanMessage>(Vector::BLF::ObjectType::CAN_MESSAGE), "CAN_MESSAGE is a CanMessage");
+    static_assert(!Vector::BLF::isInstanceOf<Vector::BLF::CanMessage>(Vector::BLF::ObjectType::CAN_MESSAGE2), "CAN_MESSAGE2 is no CanMessage");
+    static_assert(Vector::BLF::isInstanceOf<Vector::BLF::ObjectHeader>(Vector::BLF::ObjectType::CAN_MESSAGE), "CanMessage is an ObjectHeader");
+    static_assert(Vector::BLF::isInstanceOf<Vector::BLF::EnvironmentVariable>(Vector::BLF::ObjectType::ENV_STRING), "ENV_STRING is an EnvironmentVariable");
+    static_assert(!Vector::BLF::isInstanceOf<Vector::BLF::CanMessage>(Vector::BLF::ObjectType::UNKNOWN), "UNKNOWN is not supported");
+}
+
+/** all objects in range based for loop */
+BOOST_AUTO_TEST_CASE(Objects) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_Objects.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_Objects.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    uint32_t canMessages = 0;
+    std::vector<std::unique_ptr<Vector::BLF::ObjectHeaderBase>> canFdMessages64;
+    for (auto & ohb : file.objects(16)) {
+        BOOST_REQUIRE(ohb);
+        if (ohb->objectType == Vector::BLF::ObjectType::CAN_MESSAGE) {
+            BOOST_CHECK_EQUAL(static_cast<Vector::BLF::CanMessage &>(*ohb).id, canMessages);
+            canMessages++;
+        } else {
+            /* keep object */
+            canFdMessages64.push_back(std::move(ohb));
+        }
+    }
+    BOOST_CHECK_EQUAL(canMessages, 1000);
+    BOOST_REQUIRE_EQUAL(canFdMessages64.size(), 100);
+    BOOST_CHECK(canFdMessages64[0]->objectType == Vector::BLF::ObjectType::CAN_FD_MESSAGE_64);
+    BOOST_CHECK(file.eof());
+    file.close();
+}
+
+/** objects of one class */
+BOOST_AUTO_TEST_CASE(Typed) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_Typed.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_Typed.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    uint32_t id = 9;
+    auto range = file.typed<Vector::BLF::CanFdMessage64>();
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        BOOST_CHECK_EQUAL((*it)->id, id);
+        id += 10;
+    }
+    BOOST_CHECK_EQUAL(id, 1009);
+    file.close();
+}
+
+/** objects are read in batches */
+BOOST_AUTO_TEST_CASE(ReadBatch) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_ReadBatch.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_ReadBatch.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    Vector::BLF::ObjectHeaderBase * objects[64];
+    std::size_t count = 0;
+    while (std::size_t n = file.read(objects, 64)) {
+        BOOST_REQUIRE_LE(n, 64);
+        for (std::size_t i = 0; i < n; ++i)
+            delete objects[i];
+        count += n;
+    }
+    BOOST_CHECK_EQUAL(count, 1100);
+    BOOST_CHECK(file.eof());
+    file.close();
+}
+
+/** loop can be left early */
+BOOST_AUTO_TEST_CASE(Break) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_Break.blf");
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ObjectRange_Break.blf", std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+
+    uint32_t id = 0;
+    for (auto & canMessage : file.typed<Vector::BLF::CanMessage>()) {
+        BOOST_CHECK_EQUAL(canMessage->id, id);
+        if (++id == 500)
+            break;
+    }
+
+    /* continue reading where the range stopped, without the batch it took */
+    Vector::BLF::ObjectHeaderBase * ohb = file.read();
+    BOOST_REQUIRE(ohb);
+    delete ohb;
+    file.close();
+}
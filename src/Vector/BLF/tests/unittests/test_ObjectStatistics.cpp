@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE ObjectStatistics
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+#include <Vector/BLF.h>
+
+/** statistics of a written file */
+BOOST_AUTO_TEST_CASE(Scan) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ObjectStatistics.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t i = 0; i < 300; i++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->channel = 1 + i % 2;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeTenMics;
+        canMessage->objectTimeStamp = 100 + i;
+        file.write(canMessage);
+
+        /* variable object size with padding, without channel */
+        auto * eventComment = new Vector::BLF::EventComment;
+        eventComment->text = std::string(i % 7, 'x');
+        eventComment->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeOneNans;
+        eventComment->objectTimeStamp = 1000000 + i;
+        file.write(eventComment);
+
+        if (i % 3 == 0) {
+            auto * canFdMessage64 = new Vector::BLF::CanFdMessage64;
+            canFdMessage64->channel = 3;
+            canFdMessage64->objectTimeStamp = 5000000;
+            file.write(canFdMessage64);
+        }
+    }
+    file.close();
+
+    Vector::BLF::ObjectStatistics objectStatistics;
+    objectStatistics.scan(CMAKE_CURRENT_BINARY_DIR "/test_ObjectStatistics.blf");
+
+    /* per object type */
+    BOOST_CHECK_EQUAL(objectStatistics.objectCount, 700);
+    BOOST_CHECK_EQUAL(objectStatistics.objectCount, objectStatistics.fileStatistics.objectCount);
+    BOOST_CHECK_EQUAL(objectStatistics.objectTypeCount[Vector::BLF::ObjectType::CAN_MESSAGE], 300);
+    BOOST_CHECK_EQUAL(objectStatistics.objectTypeCount[Vector::BLF::ObjectType::EVENT_COMMENT], 300);
+    BOOST_CHECK_EQUAL(objectStatistics.objectTypeCount[Vector::BLF::ObjectType::CAN_FD_MESSAGE_64], 100);
+
+    /* per channel */
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount.size(), 3);
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount[1], 150);
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount[2], 150);
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount[3], 100);
+
+    /* sizes */
+    BOOST_CHECK_GT(objectStatistics.logContainerCount, 1);
+    BOOST_CHECK_GT(objectStatistics.objectSize, 700 * 32);
+    BOOST_CHECK_LE(objectStatistics.objectSize, objectStatistics.uncompressedSize);
+    BOOST_CHECK_EQUAL(objectStatistics.uncompressedSize + objectStatistics.logContainerCount * 32, objectStatistics.fileStatistics.uncompressedFileSize - objectStatistics.fileStatistics.statisticsSize);
+
+    /* time span */
+    BOOST_CHECK_EQUAL(objectStatistics.firstObjectTimeStamp, 1000000);
+    BOOST_CHECK_EQUAL(objectStatistics.lastObjectTimeStamp, 5000000);
+}
+
+/** one byte channel of CAN FD 64 objects, followed by dlc */
+BOOST_AUTO_TEST_CASE(CanFd64Channel) {
+    Vector::BLF::File file;
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ObjectStatistics_CanFd64Channel.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    auto * canFdMessage64 = new Vector::BLF::CanFdMessage64;
+    canFdMessage64->channel = 1;
+    canFdMessage64->dlc = 8;
+    canFdMessage64->validDataBytes = 8;
+    canFdMessage64->data.resize(8);
+    file.write(canFdMessage64);
+    auto * canFdErrorFrame64 = new Vector::BLF::CanFdErrorFrame64;
+    canFdErrorFrame64->channel = 2;
+    canFdErrorFrame64->dlc = 15;
+    file.write(canFdErrorFrame64);
+    file.close();
+
+BOOST_CHECK_EQUAL(Vector::BLF::ObjectStatistics::channelSize(Vector::BLF::ObjectType::CAN_FD_MESSAGE_64), 1);
+BOOST_CHECK_EQUAL(Vector::BLF::ObjectStatistics::channelSize(Vector::BLF::ObjectType::CAN_FD_ERROR_64), 1);
+BOOST_CHECK_EQUAL(Vector::BLF::ObjectStatistics::channelSize(Vector::BLF::ObjectType::CAN_MESSAGE), 2);
+BOOST_CHECK_EQUAL(Vector::BLF::ObjectStatistics::channelSize(Vector::BLF::ObjectType::EVENT_COMMENT), 0);
+
+    Vector::BLF::ObjectStatistics objectStatistics;
+    objectStatistics.scan(CMAKE_CURRENT_BINARY_DIR "/test_ObjectStatistics_CanFd64Channel.blf");
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount.size(), 2);
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount[1], 1);
+    BOOST_CHECK_EQUAL(objectStatistics.channelCount[2], 1);
+}
+
+/** header only scan of a file from CANoe */
+BOOST_AUTO_TEST_CASE(CanMessageFile) {
+    Vector::BLF::ObjectStatistics objectStatistics;
+    objectStatistics.scan(CMAKE_CURRENT_SOURCE_DIR "/events_from_binlog/test_CanMessage.blf");
+    BOOST_CHECK_EQUAL(objectStatistics.objectCount, objectStatistics.fileStatistics.objectCount);
+    BOOST_CHECK_EQUAL(objectStatistics.objectTypeCount[Vector::BLF::ObjectType::CAN_MESSAGE], objectStatistics.objectCount);
+}
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE ParallelFileReader
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <array>
+#include <string>
+
+#include <Vector/BLF.h>
+
+/** aggregation result */
+struct Statistics {
+    /** number of CAN messages per channel */
+    std::array<uint32_t, 4> canMessages {};
+
+    /** sum of CAN message ids */
+    uint64_t idSum {};
+
+    /** number of event comments */
+    uint32_t eventComments {};
+
+    /** sum of event comment text lengths */
+    uint64_t textLengthSum {};
+
+    /** number of event comments with unexpected text */
+    uint32_t textErrors {};
+};
+
+/** accumulate an object */
+static void map(Statistics & statistics, const Vector::BLF::ObjectHeaderBase & ohb) {
+    if (ohb.objectType == Vector::BLF::ObjectType::CAN_MESSAGE) {
+        const auto & canMessage = static_cast<const Vector::BLF::CanMessage &>(ohb);
+        statistics.canMessages.at(canMessage.channel)++;
+        statistics.idSum += canMessage.id;
+    }
+    if (ohb.objectType == Vector::BLF::ObjectType::EVENT_COMMENT) {
+        const auto & eventComment = static_cast<const Vector::BLF::EventComment &>(ohb);
+        if (eventComment.text != std::string(eventComment.commentedEventType, 'x'))
+            statistics.textErrors++;
+        statistics.eventComments++;
+        statistics.textLengthSum += eventComment.text.size();
+    }
+}
+
+/** merge two accumulators */
+static void reduce(Statistics & statistics, const Statistics & other) {
+    for (std::size_t channel = 0; channel < statistics.canMessages.size(); ++channel)
+        statistics.canMessages[channel] += other.canMessages[channel];
+    statistics.idSum += other.idSum;
+    statistics.eventComments += other.eventComments;
+    statistics.textLengthSum += other.textLengthSum;
+    statistics.textErrors += other.textErrors;
+}
+
+/** write a file with objects straddling many small LogContainers */
+static void writeFile(const char * filename) {
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.open(filename, std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->channel = i % 4;
+        canMessage->id = i;
+        file.write(canMessage);
+
+        /* variable object size with padding */
+        auto * eventComment = new Vector::BLF::EventComment;
+        eventComment->commentedEventType = i % 7;
+        eventComment->text = std::string(i % 7, 'x');
+        file.write(eventComment);
+    }
+    file.close();
+}
+
+/** aggregate with several rounds of small partitions */
+BOOST_AUTO_TEST_CASE(SmallPartitions) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_ParallelFileReader.blf");
+
+    Vector::BLF::ParallelFileReader reader;
+    reader.threadCount = 3;
+    reader.partitionSize = 0x400;
+    BOOST_CHECK_EQUAL(reader.workerCount(), 3);
+    Statistics statistics = reader.mapReduce(CMAKE_CURRENT_BINARY_DIR "/test_ParallelFileReader.blf", Statistics(), map, reduce);
+    for (uint32_t count : statistics.canMessages)
+        BOOST_CHECK_EQUAL(count, 250);
+    BOOST_CHECK_EQUAL(statistics.idSum, 999 * 1000 / 2);
+    BOOST_CHECK_EQUAL(statistics.eventComments, 1000);
+    BOOST_CHECK_EQUAL(statistics.textLengthSum, 2997);
+    BOOST_CHECK_EQUAL(statistics.textErrors, 0);
+    BOOST_CHECK_EQUAL(reader.fileStatistics.objectCount, 2000);
+}
+
+/** aggregate with a single partition */
+BOOST_AUTO_TEST_CASE(SinglePartition) {
+    writeFile(CMAKE_CURRENT_BINARY_DIR "/test_ParallelFileReader.blf");
+
+    Vector::BLF::ParallelFileReader reader;
+    reader.threadCount = 1;
+    uint32_t objectCount = reader.mapReduce(CMAKE_CURRENT_BINARY_DIR "/test_ParallelFileReader.blf", 0U,
+    [](uint32_t & count, const Vector::BLF::ObjectHeaderBase &) {
+        count++;
+    },
+    [](uint32_t & count, const uint32_t & other) {
+        count += other;
+    });
+    BOOST_CHECK_EQUAL(objectCount, 2000);
+}
+
+/** objects larger than a partition, that span several partitions */
+BOOST_AUTO_TEST_CASE(LargeObjects) {
+    /* write file */
+    Vector::BLF::File file;
+    file.setDefaultLogContainerSize(0x100);
+    file.open(CMAKE_CURRENT_BINARY_DIR "/test_ParallelFileReader_LargeObjects.blf", std::ios_base::out);
+    BOOST_REQUIRE(file.is_open());
+    for (uint32_t i = 0; i < 100; i++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->channel = i % 4;
+        canMessage->id = i;
+        file.write(canMessage);
+
+        if (i % 50 == 10) {
+            auto * eventComment = new Vector::BLF::EventComment;
+            eventComment->commentedEventType = 5000;
+            eventComment->text = std::string(5000, 'x');
+            file.write(eventComment);
+        }
+    }
+    file.close();
+
+    for (unsigned int threadCount = 1; threadCount <= 3; threadCount++) {
+        Vector::BLF::ParallelFileReader reader;
+        reader.threadCount = threadCount;
+        reader.partitionSize = 0x400;
+        Statistics statistics = reader.mapReduce(CMAKE_CURRENT_BINARY_DIR "/test_ParallelFileReader_LargeObjects.blf", Statistics(), map, reduce);
+        for (uint32_t count : statistics.canMessages)
+            BOOST_CHECK_EQUAL(count, 25);
+        BOOST_CHECK_EQUAL(statistics.idSum, 99 * 100 / 2);
+        BOOST_CHECK_EQUAL(statistics.eventComments, 2);
+        BOOST_CHECK_EQUAL(statistics.textLengthSum, 10000);
+        BOOST_CHECK_EQUAL(statistics.textErrors, 0);
+    }
+}
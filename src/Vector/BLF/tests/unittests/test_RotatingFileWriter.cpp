@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: 2013-2021 Tobias Lorenz <tobias.lorenz@gmx.net>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define BOOST_TEST_MODULE RotatingFileWriter
+#if !defined(WIN32)
+#define BOOST_TEST_DYN_LINK
+#endif
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <vector>
+
+#include <Vector/BLF.h>
+
+/**
+ * Read CAN message ids of a file.
+ *
+ * @param[in] fileName file name
+ * @param[out] fileStatistics file statistics
+ * @return CAN message ids
+ */
+static std::vector<uint32_t> readIds(const std::string & fileName, Vector::BLF::FileStatistics & fileStatistics) {
+    std::vector<uint32_t> ids;
+    Vector::BLF::File file;
+    file.open(fileName, std::ios_base::in);
+    BOOST_REQUIRE(file.is_open());
+    fileStatistics = file.fileStatistics;
+    while (Vector::BLF::ObjectHeaderBase * ohb = file.read()) {
+        /* skip restore points */
+        if (ohb->objectType == Vector::BLF::ObjectType::Unknown115) {
+            delete ohb;
+            continue;
+        }
+        auto * canMessage = dynamic_cast<Vector::BLF::CanMessage *>(ohb);
+        BOOST_REQUIRE(canMessage != nullptr);
+        ids.push_back(canMessage->id);
+        delete ohb;
+    }
+    file.close();
+    return ids;
+}
+
+/** rotate after a number of objects */
+BOOST_AUTO_TEST_CASE(MaxObjectCount) {
+    Vector::BLF::RotatingFileWriter writer;
+    writer.fileStatistics.measurementStartTime = {2021, 12, 5, 31, 23, 59, 58, 0};
+    writer.maxObjectCount = 30;
+    writer.open(CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MaxObjectCount");
+    BOOST_REQUIRE(writer.is_open());
+    for (uint32_t id = 0; id < 100; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        writer.write(canMessage);
+    }
+    writer.close();
+    BOOST_CHECK(!writer.is_open());
+
+    /* all objects are in the files, without gaps */
+    std::vector<std::string> fileNames = writer.fileNames();
+    BOOST_REQUIRE_EQUAL(fileNames.size(), 4);
+    BOOST_CHECK_EQUAL(fileNames[0], CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MaxObjectCount_0000.blf");
+    BOOST_CHECK_EQUAL(fileNames[3], CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MaxObjectCount_0003.blf");
+    uint32_t nextId = 0;
+    for (const std::string & fileName : fileNames) {
+        Vector::BLF::FileStatistics fileStatistics;
+        std::vector<uint32_t> ids = readIds(fileName, fileStatistics);
+        BOOST_CHECK_EQUAL(fileStatistics.objectCount, ids.size());
+        BOOST_CHECK_EQUAL(fileStatistics.measurementStartTime.year, 2021);
+        BOOST_CHECK_EQUAL(fileStatistics.measurementStartTime.second, 58);
+        BOOST_CHECK_LE(ids.size(), 30);
+        for (uint32_t id : ids)
+            BOOST_CHECK_EQUAL(id, nextId++);
+    }
+    BOOST_CHECK_EQUAL(nextId, 100);
+}
+
+/** rotate after a measurement duration */
+BOOST_AUTO_TEST_CASE(MaxDuration) {
+    Vector::BLF::RotatingFileWriter writer;
+    writer.maxDuration = std::chrono::milliseconds(25);
+    writer.open(CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MaxDuration");
+    BOOST_REQUIRE(writer.is_open());
+    for (uint32_t id = 0; id < 100; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        canMessage->objectFlags = Vector::BLF::ObjectHeader::ObjectFlags::TimeTenMics;
+        canMessage->objectTimeStamp = id * 100; // 1ms
+        writer.write(canMessage);
+    }
+    writer.close();
+
+    /* 25 objects per file */
+    std::vector<std::string> fileNames = writer.fileNames();
+    BOOST_REQUIRE_EQUAL(fileNames.size(), 4);
+    for (const std::string & fileName : fileNames) {
+        Vector::BLF::FileStatistics fileStatistics;
+        BOOST_CHECK_EQUAL(readIds(fileName, fileStatistics).size(), 25);
+    }
+}
+
+/** rotate before the file size is exceeded */
+BOOST_AUTO_TEST_CASE(MaxFileSize) {
+    Vector::BLF::RotatingFileWriter writer;
+    writer.compressionLevel = 0;
+    writer.writeRestorePoints = false;
+    writer.defaultLogContainerSize = 0x100;
+    writer.maxFileSize = 1000;
+    writer.open(CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MaxFileSize");
+    BOOST_REQUIRE(writer.is_open());
+    for (uint32_t id = 0; id < 100; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        writer.write(canMessage);
+    }
+    writer.close();
+
+    /* 144 bytes FileStatistics, 15 * 48 bytes CanMessage, 3 * 32 bytes LogContainer header */
+    std::vector<std::string> fileNames = writer.fileNames();
+    BOOST_REQUIRE_EQUAL(fileNames.size(), 7);
+    uint32_t nextId = 0;
+    for (const std::string & fileName : fileNames) {
+        BOOST_CHECK_LE(boost::filesystem::file_size(fileName), writer.maxFileSize);
+        Vector::BLF::FileStatistics fileStatistics;
+        std::vector<uint32_t> ids = readIds(fileName, fileStatistics);
+        BOOST_CHECK_EQUAL(ids.size(), (fileName == fileNames.back()) ? 10 : 15);
+        for (uint32_t id : ids)
+            BOOST_CHECK_EQUAL(id, nextId++);
+    }
+    BOOST_CHECK_EQUAL(nextId, 100);
+}
+
+/** rotate close to the compressed file size */
+BOOST_AUTO_TEST_CASE(MaxCompressedFileSize) {
+    Vector::BLF::RotatingFileWriter writer;
+    writer.compressionLevel = 6;
+    writer.writeRestorePoints = false;
+    writer.defaultLogContainerSize = 0x1000;
+    writer.maxFileSize = 0x4000;
+    writer.open(CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MaxCompressedFileSize");
+    BOOST_REQUIRE(writer.is_open());
+    for (uint32_t id = 0; id < 20000; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        canMessage->dlc = 8;
+        canMessage->data[0] = static_cast<uint8_t>(id * 7);
+        writer.write(canMessage);
+    }
+    writer.close();
+
+    /* files fall short of the limit by at most one LogContainer */
+    std::vector<std::string> fileNames = writer.fileNames();
+    BOOST_REQUIRE_GE(fileNames.size(), 2);
+    uint32_t nextId = 0;
+    for (const std::string & fileName : fileNames) {
+        uint64_t fileSize = boost::filesystem::file_size(fileName);
+        BOOST_CHECK_LE(fileSize, writer.maxFileSize);
+        if (fileName != fileNames.back())
+            BOOST_CHECK_GE(fileSize, writer.maxFileSize - writer.defaultLogContainerSize - 0x100);
+        Vector::BLF::FileStatistics fileStatistics;
+        for (uint32_t id : readIds(fileName, fileStatistics))
+            BOOST_CHECK_EQUAL(id, nextId++);
+    }
+    BOOST_CHECK_EQUAL(nextId, 20000);
+}
+
+/** measurementStartTime defaults to the time of open */
+BOOST_AUTO_TEST_CASE(MeasurementStartTime) {
+    Vector::BLF::RotatingFileWriter writer;
+    writer.maxObjectCount = 1;
+    writer.open(CMAKE_CURRENT_BINARY_DIR "/test_RotatingFileWriter_MeasurementStartTime");
+    BOOST_REQUIRE(writer.is_open());
+    BOOST_CHECK_NE(writer.fileStatistics.measurementStartTime.year, 0);
+    for (uint32_t id = 0; id < 3; id++) {
+        auto * canMessage = new Vector::BLF::CanMessage;
+        canMessage->id = id;
+        writer.write(canMessage);
+    }
+    writer.close();
+
+    /* all files have the same measurementStartTime */
+    std::vector<std::string> fileNames = writer.fileNames();
+    BOOST_REQUIRE_EQUAL(fileNames.size(), 3);
+    for (const std::string & fileName : fileNames) {
+        Vector::BLF::FileStatistics fileStatistics;
+        readIds(fileName, fileStatistics);
+        BOOST_CHECK_EQUAL(Vector::BLF::systemTimeToNs(fileStatistics.measurementStartTime), Vector::BLF::systemTimeToNs(writer.fileStatistics.measurementStartTime));
+    }
+}
@@ -9,7 +9,9 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <sstream>
+#include <vector>
 #include <Vector/BLF.h>
 
 /** Open a file, read/write on it, close it again. */
@@ -236,3 +238,32 @@ BOOST_AUTO_TEST_CASE(StdStringStream2) {
     BOOST_CHECK_EQUAL(ss.good(), uncompressedFile.good());
     BOOST_CHECK_EQUAL(ss.eof(), uncompressedFile.eof());
 }
+
+/** Read complete LogContainers without copying their data. */
+BOOST_AUTO_TEST_CASE(ReadLogContainer) {
+    Vector::BLF::UncompressedFile uncompressedFile;
+    uncompressedFile.setDefaultLogContainerSize(16);
+
+    /* write one and a half log container */
+    std::vector<char> data(24);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i);
+    uncompressedFile.write(data.data(), static_cast<std::streamsize>(data.size()));
+    uncompressedFile.setFileSize(uncompressedFile.tellp());
+
+    /* the complete log container is handed over */
+    std::shared_ptr<Vector::BLF::LogContainer> logContainer1 = uncompressedFile.readLogContainer();
+    BOOST_CHECK(uncompressedFile.good());
+    BOOST_CHECK_EQUAL(uncompressedFile.gcount(), 16);
+    BOOST_CHECK_EQUAL(logContainer1->uncompressedFileSize, 16);
+    BOOST_CHECK_EQUAL(logContainer1->filePosition, 0);
+    BOOST_CHECK(std::equal(data.begin(), data.begin() + 16, logContainer1->uncompressedFile.begin()));
+
+    /* the rest is copied */
+    std::shared_ptr<Vector::BLF::LogContainer> logContainer2 = uncompressedFile.readLogContainer();
+    BOOST_CHECK(uncompressedFile.eof());
+    BOOST_CHECK_EQUAL(uncompressedFile.gcount(), 8);
+    BOOST_CHECK_EQUAL(logContainer2->uncompressedFileSize, 8);
+    BOOST_CHECK_EQUAL(logContainer2->uncompressedFile.size(), 8);
+    BOOST_CHECK(std::equal(data.begin() + 16, data.end(), logContainer2->uncompressedFile.begin()));
+}